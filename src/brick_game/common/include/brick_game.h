@@ -0,0 +1,279 @@
+#ifndef BRICK_GAME_H
+#define BRICK_GAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FIELD_WIDTH 10        // Ширина поля по умолчанию
+#define FIELD_HEIGHT 20       // Высота поля по умолчанию
+#define FIELD_WIDTH_MAX 64    // Строка поля помещается в 64-битное слово
+#define FIELD_HEIGHT_MAX 32
+#define FIELD_SIZE_MIN 4      // Меньшее поле не вмещает фигуру
+#define NEXT_SIZE 4
+#define ENGINE_ACTIVE_MAX 16     // Клеток в движущемся объекте, не больше
+#define ENGINE_CELL_KINDS_MAX 15  // Видов занятых клеток, не больше
+#define ENGINE_STATUS_SIZE 128   // Буфер строки состояния engineStatus
+#define ENGINE_ENCODED_MAX 2048  // Буфер упакованной игры engineEncode
+#define ENGINE_REPEAT_DELAY_MS 170    // Задержка автоповтора по умолчанию
+#define ENGINE_REPEAT_INTERVAL_MS 50  // Интервал автоповтора по умолчанию
+
+/**
+ * @brief Клетка поля: 0 — пусто, иначе вид клетки 1..cell_kinds игры
+ */
+typedef uint8_t Cell_t;
+
+#define CELL_EMPTY 0
+
+/**
+ * @brief Перечисление действий пользователя
+ */
+typedef enum {
+  Start,
+  Pause,
+  Terminate,
+  Left,
+  Right,
+  Up,
+  Down,
+  Action
+} UserAction_t;
+
+/**
+ * @brief Структура с информацией о текущем состоянии игры
+ */
+typedef struct {
+  Cell_t (*field)[FIELD_WIDTH_MAX];  // Игровое поле (строки клеток)
+  int **next;                        // Следующая фигура (матрица)
+  int score;                         // Текущий счет
+  int high_score;                    // Лучший счет
+  int level;                         // Уровень игры
+  int speed;                         // Скорость игры
+  int pause;                         // Флаг паузы
+  int width;   // Ширина поля: в строке field заняты первые width клеток
+  int height;  // Высота поля, строк field
+} GameInfo_t;
+
+/**
+ * @brief Состояние игры с точки зрения интерфейса
+ */
+typedef enum {
+  ENGINE_START,    // Заставка, ожидание Start
+  ENGINE_PLAYING,  // Игра идет
+  ENGINE_PAUSED,
+  ENGINE_OVER,     // Игра окончена, Start начинает новую
+  ENGINE_EXIT      // Игрок вышел
+} EngineState_t;
+
+/**
+ * @brief Цвета терминала в порядке ANSI (совпадают с COLOR_* ncurses)
+ */
+typedef enum {
+  ENGINE_BLACK,
+  ENGINE_RED,
+  ENGINE_GREEN,
+  ENGINE_YELLOW,
+  ENGINE_BLUE,
+  ENGINE_MAGENTA,
+  ENGINE_CYAN,
+  ENGINE_WHITE
+} EngineColor_t;
+
+/**
+ * @brief Цвет вида клетки; черный фон — фон терминала
+ */
+typedef struct {
+  uint8_t fg;  // EngineColor_t
+  uint8_t bg;  // EngineColor_t
+} EngineColors_t;
+
+/**
+ * @brief Неизменное описание игры для интерфейсов
+ */
+typedef struct {
+  const char *title;              // Название на рамке поля и заставке
+  int cell_kinds;                 // Виды клеток 1..cell_kinds
+  const EngineColors_t *palette;  // Цвет клетки c — palette[c - 1]
+} EngineInfo_t;
+
+/**
+ * @brief Клетка движущегося объекта (фигуры), которой еще нет в поле
+ */
+typedef struct {
+  int8_t x, y;
+  Cell_t cell;
+} EngineCell_t;
+
+// Основные функции API, общие для всех игр
+/**
+ * @brief Обрабатывает пользовательский ввод
+ *
+ * Нажатие с hold = true начинает удержание: движок сам повторяет действие
+ * по игровому времени (см. engineAutoRepeat), пока не придет то же действие
+ * с hold = false — отпускание, которое само действие не выполняет.
+ * Удержание поддерживают не все действия и не все игры; для остальных hold
+ * ничего не меняет.
+ * @param action Действие пользователя
+ * @param hold Флаг удержания клавиши
+ */
+void userInput(UserAction_t action, bool hold);
+
+/**
+ * @brief Обновляет текущее состояние игры по часам потока (см. gameclock.h)
+ * @return Структура с информацией о текущем состоянии игры
+ */
+GameInfo_t updateCurrentState();
+
+// Движок игры. Каждая игра реализует эти функции в своей библиотеке, и
+// интерфейсы вызывают их напрямую: какая игра отвечает, решает компоновщик
+
+/**
+ * @brief Возвращает описание игры
+ * @return Указатель на статическую структуру
+ */
+const EngineInfo_t *engineInfo(void);
+
+/**
+ * @brief Готовит игру в текущем потоке: таблицы, рекорд, первая партия
+ */
+void engineInit(void);
+
+/**
+ * @brief Начинает новую партию с заданным зерном и нулевым игровым временем
+ *
+ * Не выделяет память и не читает таблицу рекордов.
+ * @param seed Зерно
+ */
+void engineNewGame(uint32_t seed);
+
+/**
+ * @brief Выходит из партии, не записывая ее результат
+ *
+ * Для выхода с сохранением партии (см. session.h): Terminate записал бы
+ * незаконченную партию в таблицу рекордов, а продолженная после загрузки
+ * партия попала бы туда второй раз.
+ */
+void engineSuspend(void);
+
+/**
+ * @brief Включает или выключает таблицу рекордов игры
+ *
+ * Выключенная таблица не читается и не пишется: лучший счет новой партии —
+ * 0, результаты не сохраняются. Для серверов, ботов и генераторов нагрузки,
+ * чьи партии не принадлежат игроку. Действует на все потоки процесса.
+ * @param record false, чтобы не вести таблицу рекордов
+ */
+void engineRecordResults(bool record);
+
+/**
+ * @brief Задает размер поля и начинает новую партию
+ *
+ * Размер сохраняется для следующих партий потока.
+ * @param width Ширина FIELD_SIZE_MIN..FIELD_WIDTH_MAX
+ * @param height Высота FIELD_SIZE_MIN..FIELD_HEIGHT_MAX
+ * @return false, если игра не поддерживает такой размер
+ */
+bool engineResize(int width, int height);
+
+/**
+ * @brief Задает автоповтор удерживаемых действий
+ *
+ * Действует до следующего вызова, в том числе в новых партиях потока.
+ * @param delay_ms Задержка первого повтора после нажатия, мс (от 1)
+ * @param interval_ms Интервал следующих повторов, мс (от 1)
+ */
+void engineAutoRepeat(int delay_ms, int interval_ms);
+
+/**
+ * @brief Освобождает ресурсы игры текущего потока
+ */
+void engineFree(void);
+
+/**
+ * @brief Возвращает состояние игры
+ * @return Состояние
+ */
+EngineState_t engineState(void);
+
+/**
+ * @brief Записывает клетки движущегося объекта
+ *
+ * Клетки за пределами поля пропускаются.
+ * @param cells Буфер на ENGINE_ACTIVE_MAX клеток
+ * @return Количество клеток
+ */
+int engineActiveCells(EngineCell_t *cells);
+
+/**
+ * @brief Продвигает игру на ms миллисекунд игрового времени без часов
+ * @param ms Длительность шага, мс
+ * @return Структура с информацией о текущем состоянии игры
+ */
+GameInfo_t engineStep(int ms);
+
+/**
+ * @brief Версия состояния игры
+ *
+ * Растет при каждом вводе и каждом изменении состояния по времени; кадр,
+ * нарисованный после чтения версии, отражает все изменения до нее.
+ * @return Версия
+ */
+uint64_t engineVersion(void);
+
+/**
+ * @brief Сколько игрового времени игра может не продвигаться
+ * @return Миллисекунды до ближайшего изменения без ввода или -1, если без
+ * ввода игра не изменится
+ */
+int64_t engineTimeout(void);
+
+/**
+ * @brief Размер снимка игры, байт
+ * @return Размер
+ */
+size_t engineSnapshotSize(void);
+
+/**
+ * @brief Сохраняет игру текущего потока
+ * @param snapshot Буфер engineSnapshotSize() байт с выравниванием
+ * max_align_t
+ */
+void engineSave(void *snapshot);
+
+/**
+ * @brief Восстанавливает игру текущего потока из снимка engineSave
+ * @param snapshot Снимок
+ */
+void engineLoad(const void *snapshot);
+
+/**
+ * @brief Упаковывает игру текущего потока в компактный переносимый вид
+ *
+ * В отличие от снимка, не зависит от раскладки структур и занимает десятки
+ * байт: годится для файлов и массового копирования состояний. Распакованная
+ * игра продолжается так же, как исходная.
+ * @param out Буфер
+ * @param size Размер буфера (ENGINE_ENCODED_MAX достаточно)
+ * @return Длина в байтах или 0, если буфер мал
+ */
+size_t engineEncode(uint8_t *out, size_t size);
+
+/**
+ * @brief Восстанавливает игру текущего потока из engineEncode
+ *
+ * Данные проверяются целиком; при ошибке игра не меняется.
+ * @param data Упакованная игра
+ * @param size Длина в байтах
+ * @return true, если игра восстановлена
+ */
+bool engineDecode(const uint8_t *data, size_t size);
+
+/**
+ * @brief Пишет строку состояния игры для сценариев и журналов
+ * @param buffer Буфер
+ * @param size Размер буфера (ENGINE_STATUS_SIZE достаточно)
+ * @return Длина строки без завершающего нуля
+ */
+int engineStatus(char *buffer, size_t size);
+
+#endif  // BRICK_GAME_H
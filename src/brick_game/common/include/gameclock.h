@@ -0,0 +1,66 @@
+#ifndef GAMECLOCK_H
+#define GAMECLOCK_H
+
+#include <stdint.h>
+
+/**
+ * @brief Источник игрового времени
+ *
+ * updateCurrentState берет время из часов потока (см. setGameClock).
+ * Пустые часы (now_ms == NULL) — монотонные часы системы.
+ */
+typedef struct {
+  int64_t (*now_ms)(void *context);  // Текущее время, мс
+  void *context;                     // Передается в now_ms
+} GameClock_t;
+
+/**
+ * @brief Виртуальные часы: время идет только по virtualClockAdvance
+ */
+typedef struct {
+  int64_t now_ms;
+} VirtualClock_t;
+
+/**
+ * @brief Возвращает время монотонных часов системы (CLOCK_MONOTONIC)
+ *
+ * Для интерфейсов, которым нужно реальное время независимо от часов игры.
+ * @return Время, мс
+ */
+int64_t monotonicMs(void);
+
+/**
+ * @brief Возвращает монотонные часы системы (CLOCK_MONOTONIC)
+ * @return Часы для игры в реальном времени
+ */
+GameClock_t monotonicClock(void);
+
+/**
+ * @brief Возвращает часы, показывающие время виртуальных часов
+ * @param clock Виртуальные часы; должны жить, пока часы используются
+ * @return Часы для симуляции быстрее реального времени и тестов
+ */
+GameClock_t virtualClock(VirtualClock_t *clock);
+
+/**
+ * @brief Продвигает виртуальные часы
+ * @param clock Виртуальные часы
+ * @param ms Шаг, мс; отрицательный не меняет время
+ */
+void virtualClockAdvance(VirtualClock_t *clock, int64_t ms);
+
+/**
+ * @brief Задает часы игры текущего потока
+ *
+ * В новых потоках идут монотонные часы.
+ * @param clock Часы
+ */
+void setGameClock(GameClock_t clock);
+
+/**
+ * @brief Возвращает время часов игры текущего потока
+ * @return Время, мс
+ */
+int64_t gameClockNow(void);
+
+#endif  // GAMECLOCK_H
@@ -0,0 +1,47 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#define HISTOGRAM_SUB 16  // Корзин на каждую степень двойки
+#define HISTOGRAM_SIZE (64 * HISTOGRAM_SUB)
+
+/**
+ * @brief Лог-линейная гистограмма неотрицательных величин
+ *
+ * Погрешность перцентиля не больше 1/HISTOGRAM_SUB. Память постоянна при
+ * любом числе значений, добавление не выделяет памяти.
+ */
+typedef struct {
+  long counts[HISTOGRAM_SIZE];
+  long count;     // Всего значений
+  long long max;  // Наибольшее значение
+} Histogram_t;
+
+/**
+ * @brief Добавляет значение
+ * @param histogram Гистограмма
+ * @param value Значение; отрицательные считаются нулем
+ */
+void histogramAdd(Histogram_t *histogram, long long value);
+
+/**
+ * @brief Возвращает перцентиль
+ * @param histogram Гистограмма
+ * @param p Доля от 0 до 1
+ * @return Нижняя граница корзины перцентиля или 0 без значений
+ */
+long long histogramPercentile(const Histogram_t *histogram, double p);
+
+/**
+ * @brief Возвращает нижнюю границу корзины
+ * @param index Номер корзины 0..HISTOGRAM_SIZE-1
+ * @return Наименьшее значение, попадающее в корзину
+ */
+long long histogramBucketValue(int index);
+
+/**
+ * @brief Очищает гистограмму
+ * @param histogram Гистограмма
+ */
+void histogramReset(Histogram_t *histogram);
+
+#endif  // HISTOGRAM_H
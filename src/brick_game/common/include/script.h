@@ -0,0 +1,72 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <stdio.h>
+
+#include "brick_game.h"
+
+#define SCRIPT_BUFFER_SIZE 65536  // Размер пакета чтения, байт
+
+/**
+ * @brief Статистика сценарного прогона
+ */
+typedef struct {
+  long actions;  // Применено действий
+  long ticks;    // Тиков
+  long invalid;  // Пропущено неизвестных символов
+  double seconds;
+} ScriptStats_t;
+
+/**
+ * @brief Переводит символ потока сценария в действие
+ *
+ * s — Start, p — Pause, q — Terminate, l — Left, r — Right, u — Up,
+ * d — Down, a — Action.
+ * @param ch Символ
+ * @param action Указатель для сохранения действия
+ * @return true если символ обозначает действие
+ */
+bool scriptAction(char ch, UserAction_t *action);
+
+/**
+ * @brief Применяет пакет символов сценария
+ *
+ * Действия применяются по порядку; заглавная буква — нажатие с удержанием
+ * (hold = true), строчная той же буквы после нее — отпускание (см.
+ * userInput). '.' — тик (см. setScriptTickStep),
+ * '?' — вывод номера тика и строки engineStatus в out, пробельные символы
+ * пропускаются.
+ * @param data Символы
+ * @param size Количество символов
+ * @param out Поток для строк состояния
+ * @param stats Статистика
+ */
+void scriptApply(const char *data, size_t size, FILE *out,
+                 ScriptStats_t *stats);
+
+/**
+ * @brief Задает функцию, вызываемую после каждого тика сценария
+ * @param hook Функция, получающая состояние после тика, или NULL
+ */
+void setScriptTickHook(void (*hook)(GameInfo_t info));
+
+/**
+ * @brief Задает игровое время тика сценария
+ * @param ms Тик продвигает игру на ms мс через engineStep; 0 — тик по часам
+ * через updateCurrentState
+ */
+void setScriptTickStep(int ms);
+
+/**
+ * @brief Управляет игрой из потока действий без ncurses
+ *
+ * Читает все доступные данные пакетами до SCRIPT_BUFFER_SIZE байт, применяет
+ * их и завершает пакет тиком. Работает до конца потока или Terminate;
+ * конец потока завершает игру действием Terminate.
+ * @param fd Дескриптор файла, канала или FIFO
+ * @param stats Указатель для сохранения статистики
+ * @return 0 при успехе, -1 при ошибке чтения
+ */
+int runScript(int fd, ScriptStats_t *stats);
+
+#endif  // SCRIPT_H
@@ -0,0 +1,49 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdint.h>
+
+#include "brick_game.h"
+
+#define SESSION_FILE "session.dat"
+#define SESSION_MAGIC 0x31534742u  // "BGS1"
+#define SESSION_VERSION 1
+
+/**
+ * @brief Заголовок файла сохраненной партии; за ним идет engineEncode
+ */
+typedef struct {
+  uint32_t magic;     // SESSION_MAGIC
+  uint16_t version;   // SESSION_VERSION
+  uint16_t size;      // Длина упакованной игры, байт
+  uint32_t game;      // Хэш названия игры: чужие сохранения не грузятся
+  uint32_t checksum;  // FNV-1a упакованной игры
+} SessionHeader_t;
+
+/**
+ * @brief Сохраняет партию текущего потока в файл
+ *
+ * Файл пишется рядом под временным именем и заменяет старый
+ * переименованием, поэтому при сбое остается прежнее сохранение.
+ * @param path Путь к файлу
+ * @return true при успешной записи
+ */
+bool saveSession(const char *path);
+
+/**
+ * @brief Продолжает сохраненную партию
+ *
+ * Файл отображается в память и проверяется целиком; при ошибке игра не
+ * меняется.
+ * @param path Путь к файлу
+ * @return true, если партия восстановлена
+ */
+bool loadSession(const char *path);
+
+/**
+ * @brief Удаляет сохранение, например после конца партии
+ * @param path Путь к файлу
+ */
+void removeSession(const char *path);
+
+#endif  // SESSION_H
@@ -0,0 +1,86 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_BITS 6  // 64 слота на уровень
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4  // Горизонт 2^24 мс — больше 4 часов
+
+/**
+ * @brief Таймер, встроенный в структуру владельца
+ */
+typedef struct TimerNode {
+  struct TimerNode *next;
+  struct TimerNode *prev;
+  uint64_t expires;  // Момент срабатывания, мс
+  bool active;
+} TimerNode_t;
+
+/**
+ * @brief Иерархическое колесо таймеров с шагом 1 мс
+ *
+ * Уровень L хранит таймеры, до которых меньше 64^(L+1) мс; при обороте
+ * младшего уровня слот старшего раскладывается вниз. Добавление и отмена —
+ * O(1), простой без таймеров ничего не стоит.
+ */
+typedef struct {
+  TimerNode_t slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];  // Головы списков
+  uint64_t now;  // Последний обработанный момент, мс
+  int count;     // Активных таймеров
+} TimerWheel_t;
+
+/**
+ * @brief Функция, вызываемая для сработавшего таймера
+ */
+typedef void (*TimerCallback_t)(TimerNode_t *timer, void *context);
+
+/**
+ * @brief Создает пустое колесо
+ * @param wheel Колесо
+ * @param now Текущий момент, мс
+ */
+void timerWheelInit(TimerWheel_t *wheel, uint64_t now);
+
+/**
+ * @brief Ставит таймер; активный таймер переставляется
+ * @param wheel Колесо
+ * @param timer Таймер
+ * @param expires Момент срабатывания, мс; прошедший срабатывает на
+ * следующем шаге
+ */
+void timerWheelAdd(TimerWheel_t *wheel, TimerNode_t *timer, uint64_t expires);
+
+/**
+ * @brief Снимает таймер, если он активен
+ * @param wheel Колесо
+ * @param timer Таймер
+ */
+void timerWheelCancel(TimerWheel_t *wheel, TimerNode_t *timer);
+
+/**
+ * @brief Продвигает колесо до момента now и вызывает сработавшие таймеры
+ *
+ * Таймер снимается до вызова callback, поэтому тот может поставить его
+ * заново.
+ * @param wheel Колесо
+ * @param now Текущий момент, мс
+ * @param callback Функция для сработавших таймеров
+ * @param context Аргумент callback
+ * @return Количество сработавших таймеров
+ */
+int timerWheelAdvance(TimerWheel_t *wheel, uint64_t now,
+                      TimerCallback_t callback, void *context);
+
+/**
+ * @brief Время до ближайшей проверки колеса
+ *
+ * Для таймеров старших уровней возвращается начало их слота, то есть
+ * оценка может быть раньше срабатывания, но не позже.
+ * @param wheel Колесо
+ * @return Миллисекунды (0 — проверить сразу) или -1, если таймеров нет
+ */
+int64_t timerWheelTimeout(const TimerWheel_t *wheel);
+
+#endif  // TIMERWHEEL_H
@@ -0,0 +1,41 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "gameclock.h"
+
+#include <time.h>
+
+static _Thread_local GameClock_t game_clock;
+
+int64_t monotonicMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int64_t monotonicNow(void *context) {
+  (void)context;
+  return monotonicMs();
+}
+
+static int64_t virtualNow(void *context) {
+  return ((const VirtualClock_t *)context)->now_ms;
+}
+
+GameClock_t monotonicClock(void) {
+  return (GameClock_t){.now_ms = monotonicNow};
+}
+
+GameClock_t virtualClock(VirtualClock_t *clock) {
+  return (GameClock_t){.now_ms = virtualNow, .context = clock};
+}
+
+void virtualClockAdvance(VirtualClock_t *clock, int64_t ms) {
+  if (ms > 0) clock->now_ms += ms;
+}
+
+void setGameClock(GameClock_t clock) { game_clock = clock; }
+
+int64_t gameClockNow(void) {
+  if (!game_clock.now_ms) return monotonicNow(NULL);
+  return game_clock.now_ms(game_clock.context);
+}
@@ -0,0 +1,38 @@
+#include "histogram.h"
+
+#include <string.h>
+
+// Значения меньше HISTOGRAM_SUB лежат в своих корзинах, остальные — в
+// HISTOGRAM_SUB корзинах своей степени двойки по следующим за старшим битам
+static int bucketIndex(long long value) {
+  if (value < HISTOGRAM_SUB) return value < 0 ? 0 : (int)value;
+  int exponent = 63 - __builtin_clzll((unsigned long long)value);
+  int sub = (int)(value >> (exponent - 4)) & (HISTOGRAM_SUB - 1);
+  return (exponent - 3) * HISTOGRAM_SUB + sub;
+}
+
+long long histogramBucketValue(int index) {
+  if (index < HISTOGRAM_SUB) return index;
+  int exponent = index / HISTOGRAM_SUB + 3;
+  return (long long)(HISTOGRAM_SUB + index % HISTOGRAM_SUB) << (exponent - 4);
+}
+
+void histogramAdd(Histogram_t *histogram, long long value) {
+  histogram->counts[bucketIndex(value)]++;
+  histogram->count++;
+  if (value > histogram->max) histogram->max = value;
+}
+
+long long histogramPercentile(const Histogram_t *histogram, double p) {
+  if (histogram->count == 0) return 0;
+  long rank = (long)(p * (double)(histogram->count - 1) + 0.5);
+  for (int i = 0; i < HISTOGRAM_SIZE; i++) {
+    rank -= histogram->counts[i];
+    if (rank < 0) return histogramBucketValue(i);
+  }
+  return histogramBucketValue(HISTOGRAM_SIZE - 1);
+}
+
+void histogramReset(Histogram_t *histogram) {
+  memset(histogram, 0, sizeof(Histogram_t));
+}
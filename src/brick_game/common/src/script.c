@@ -0,0 +1,99 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "script.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+bool scriptAction(char ch, UserAction_t *action) {
+  switch (ch) {
+    case 's':
+      *action = Start;
+      return true;
+    case 'p':
+      *action = Pause;
+      return true;
+    case 'q':
+      *action = Terminate;
+      return true;
+    case 'l':
+      *action = Left;
+      return true;
+    case 'r':
+      *action = Right;
+      return true;
+    case 'u':
+      *action = Up;
+      return true;
+    case 'd':
+      *action = Down;
+      return true;
+    case 'a':
+      *action = Action;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void (*tick_hook)(GameInfo_t info);
+static int tick_step;
+
+void setScriptTickHook(void (*hook)(GameInfo_t info)) { tick_hook = hook; }
+
+void setScriptTickStep(int ms) { tick_step = ms > 0 ? ms : 0; }
+
+static void tick(ScriptStats_t *stats) {
+  GameInfo_t info = tick_step ? engineStep(tick_step) : updateCurrentState();
+  if (tick_hook) tick_hook(info);
+  stats->ticks++;
+}
+
+void scriptApply(const char *data, size_t size, FILE *out,
+                 ScriptStats_t *stats) {
+  for (size_t i = 0; i < size && engineState() != ENGINE_EXIT; i++) {
+    UserAction_t action;
+    // Заглавная буква — нажатие с удержанием
+    bool hold = isupper((unsigned char)data[i]);
+    if (scriptAction((char)tolower((unsigned char)data[i]), &action)) {
+      userInput(action, hold);
+      stats->actions++;
+    } else if (data[i] == '.') {
+      tick(stats);
+    } else if (data[i] == '?') {
+      char status[ENGINE_STATUS_SIZE];
+      engineStatus(status, sizeof(status));
+      fprintf(out, "tick %ld %s\n", stats->ticks, status);
+      fflush(out);
+    } else if (!isspace((unsigned char)data[i])) {
+      stats->invalid++;
+    }
+  }
+}
+
+int runScript(int fd, ScriptStats_t *stats) {
+  static char buffer[SCRIPT_BUFFER_SIZE];
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  int result = 0;
+  while (engineState() != ENGINE_EXIT) {
+    ssize_t size = read(fd, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR) continue;
+    if (size < 0) result = -1;
+    if (size <= 0) break;
+
+    // Все, что успело накопиться в канале, применяется за один тик
+    scriptApply(buffer, (size_t)size, stdout, stats);
+    if (engineState() != ENGINE_EXIT) tick(stats);
+  }
+  // Конец потока завершает игру так же, как клавиша Q
+  if (engineState() != ENGINE_EXIT) userInput(Terminate, false);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  stats->seconds =
+      (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  return result;
+}
@@ -0,0 +1,76 @@
+#define _DEFAULT_SOURCE
+
+#include "session.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint32_t fnv1a(const void *data, size_t size) {
+  const uint8_t *bytes = data;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 16777619u;
+  return hash;
+}
+
+static uint32_t gameHash(void) {
+  const char *title = engineInfo()->title;
+  return fnv1a(title, strlen(title));
+}
+
+bool saveSession(const char *path) {
+  uint8_t buffer[sizeof(SessionHeader_t) + ENGINE_ENCODED_MAX];
+  size_t size =
+      engineEncode(buffer + sizeof(SessionHeader_t), ENGINE_ENCODED_MAX);
+  if (size == 0) return false;
+  SessionHeader_t header = {SESSION_MAGIC, SESSION_VERSION, (uint16_t)size,
+                            gameHash(),
+                            fnv1a(buffer + sizeof(header), size)};
+  memcpy(buffer, &header, sizeof(header));
+  size += sizeof(header);
+
+  char temp[4096];
+  if (snprintf(temp, sizeof(temp), "%s.tmp", path) >= (int)sizeof(temp)) {
+    return false;
+  }
+  int fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return false;
+  bool written = write(fd, buffer, size) == (ssize_t)size && fsync(fd) == 0;
+  written = close(fd) == 0 && written;
+  if (!written || rename(temp, path) != 0) {
+    unlink(temp);
+    return false;
+  }
+  return true;
+}
+
+bool loadSession(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  bool loaded = false;
+  if (fstat(fd, &st) == 0 && st.st_size > (off_t)sizeof(SessionHeader_t) &&
+      st.st_size <= (off_t)(sizeof(SessionHeader_t) + ENGINE_ENCODED_MAX)) {
+    size_t size = (size_t)st.st_size;
+    const uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      SessionHeader_t header;
+      memcpy(&header, data, sizeof(header));
+      const uint8_t *payload = data + sizeof(header);
+      loaded = header.magic == SESSION_MAGIC &&
+               header.version == SESSION_VERSION &&
+               header.size == size - sizeof(header) &&
+               header.game == gameHash() &&
+               header.checksum == fnv1a(payload, header.size) &&
+               engineDecode(payload, header.size);
+      munmap((void *)data, size);
+    }
+  }
+  close(fd);
+  return loaded;
+}
+
+void removeSession(const char *path) { unlink(path); }
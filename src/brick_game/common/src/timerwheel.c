@@ -0,0 +1,131 @@
+#include "timerwheel.h"
+
+#include <stddef.h>
+
+#define LEVEL_SHIFT(level) ((level) * TIMER_WHEEL_BITS)
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+#define WHEEL_SPAN (1ull << LEVEL_SHIFT(TIMER_WHEEL_LEVELS))
+
+static bool slotEmpty(const TimerNode_t *head) { return head->next == head; }
+
+void timerWheelInit(TimerWheel_t *wheel, uint64_t now) {
+  for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+      TimerNode_t *head = &wheel->slots[level][slot];
+      head->next = head->prev = head;
+    }
+  }
+  wheel->now = now;
+  wheel->count = 0;
+}
+
+static void detach(TimerNode_t *timer) {
+  timer->prev->next = timer->next;
+  timer->next->prev = timer->prev;
+  timer->next = timer->prev = NULL;
+}
+
+// Кладет таймер в слот по расстоянию до срабатывания, но не раньше earliest.
+// При раскладке earliest — текущий момент: его слот обрабатывается следом
+static void place(TimerWheel_t *wheel, TimerNode_t *timer, uint64_t earliest) {
+  uint64_t expires = timer->expires;
+  if (expires < earliest) expires = earliest;
+  // Дальше горизонта таймер ждет в старшем уровне и раскладывается повторно
+  if (expires - wheel->now >= WHEEL_SPAN) expires = wheel->now + WHEEL_SPAN - 1;
+
+  int level = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 &&
+         expires - wheel->now >= 1ull << LEVEL_SHIFT(level + 1)) {
+    level++;
+  }
+  TimerNode_t *head =
+      &wheel->slots[level][(expires >> LEVEL_SHIFT(level)) & SLOT_MASK];
+  timer->next = head;
+  timer->prev = head->prev;
+  head->prev->next = timer;
+  head->prev = timer;
+}
+
+void timerWheelAdd(TimerWheel_t *wheel, TimerNode_t *timer, uint64_t expires) {
+  if (timer->active) {
+    detach(timer);
+  } else {
+    timer->active = true;
+    wheel->count++;
+  }
+  timer->expires = expires;
+  place(wheel, timer, wheel->now + 1);
+}
+
+void timerWheelCancel(TimerWheel_t *wheel, TimerNode_t *timer) {
+  if (!timer->active) return;
+  detach(timer);
+  timer->active = false;
+  wheel->count--;
+}
+
+// Раскладывает слот уровня level, к которому подошло время, по младшим
+static void cascade(TimerWheel_t *wheel, int level) {
+  TimerNode_t *head =
+      &wheel->slots[level][(wheel->now >> LEVEL_SHIFT(level)) & SLOT_MASK];
+  if (slotEmpty(head)) return;
+  TimerNode_t list = *head;
+  // Отцепляем весь список, чтобы place не встретил его снова
+  list.next->prev = &list;
+  list.prev->next = &list;
+  head->next = head->prev = head;
+  while (!slotEmpty(&list)) {
+    TimerNode_t *timer = list.next;
+    detach(timer);
+    place(wheel, timer, wheel->now);
+  }
+}
+
+int timerWheelAdvance(TimerWheel_t *wheel, uint64_t now,
+                      TimerCallback_t callback, void *context) {
+  int fired = 0;
+  if (wheel->count == 0 && now > wheel->now) wheel->now = now;
+
+  while (wheel->now < now) {
+    wheel->now++;
+    // На обороте уровня раскладываем следующий слот старшего
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+      if (wheel->now & ((1ull << LEVEL_SHIFT(level)) - 1)) break;
+      cascade(wheel, level);
+    }
+    TimerNode_t *head = &wheel->slots[0][wheel->now & SLOT_MASK];
+    while (!slotEmpty(head)) {
+      TimerNode_t *timer = head->next;
+      timerWheelCancel(wheel, timer);
+      if (timer->expires > wheel->now) {
+        timerWheelAdd(wheel, timer, timer->expires);
+        continue;
+      }
+      fired++;
+      callback(timer, context);
+    }
+    if (wheel->count == 0) wheel->now = now;
+  }
+  return fired;
+}
+
+int64_t timerWheelTimeout(const TimerWheel_t *wheel) {
+  if (wheel->count == 0) return -1;
+
+  uint64_t best = UINT64_MAX;
+  for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    int shift = LEVEL_SHIFT(level);
+    uint64_t base = wheel->now >> shift;
+    // Слот старшего уровня проверяется, когда до него дойдет раскладка;
+    // текущий индекс означает следующий оборот
+    for (int i = 1; i <= TIMER_WHEEL_SLOTS; i++) {
+      uint64_t index = base + (uint64_t)i;
+      if (!slotEmpty(&wheel->slots[level][index & SLOT_MASK])) {
+        uint64_t start = index << shift;
+        if (start < best) best = start;
+        break;
+      }
+    }
+  }
+  return best <= wheel->now ? 0 : (int64_t)(best - wheel->now);
+}
@@ -0,0 +1,77 @@
+#ifndef AI_H
+#define AI_H
+
+#include "eval.h"
+#include "tetris.h"
+
+#define AI_MAX_ACTIONS 16  // Максимальная длина плана для одной фигуры
+#define AI_MAX_CANDIDATES (4 * (FIELD_WIDTH + 3))  // Размещений на фигуру
+
+/**
+ * @brief Веса оценочной функции
+ *
+ * Индексы — BoardFeature_t. Признак FEATURE_COMPLETE_LINES при оценке
+ * размещения означает число линий, очищенных этим размещением.
+ */
+typedef struct {
+  double weights[FEATURE_COUNT];
+} AiWeights_t;
+
+/**
+ * @brief Выбранное размещение текущей фигуры
+ */
+typedef struct {
+  int rotation;  // Итоговый поворот
+  int x;         // Итоговая координата X
+  double score;  // Оценка позиции после размещения
+} AiMove_t;
+
+/**
+ * @brief Веса по умолчанию
+ */
+extern const AiWeights_t ai_default_weights;
+
+/**
+ * @brief Перечисляет размещения текущей фигуры с оценками
+ *
+ * Размещения те же, что рассматривает aiFindMove, в порядке перебора:
+ * повороты от текущего, для каждого — сдвиги влево, затем вправо.
+ * @param weights Веса оценочной функции
+ * @param moves Буфер не меньше AI_MAX_CANDIDATES
+ * @return Количество размещений; 0 на поле не по умолчанию
+ */
+int aiListMoves(const AiWeights_t *weights, AiMove_t *moves);
+
+/**
+ * @brief Находит лучшее размещение текущей фигуры
+ *
+ * Рассматриваются размещения, достижимые поворотом на месте появления,
+ * сдвигом по горизонтали и сбросом вниз. Бот играет только на поле
+ * размера по умолчанию.
+ * @param weights Веса оценочной функции
+ * @param move Указатель для сохранения размещения
+ * @return true если найдено хотя бы одно размещение
+ */
+bool aiFindMove(const AiWeights_t *weights, AiMove_t *move);
+
+/**
+ * @brief Находит лучшее размещение с учетом следующей фигуры
+ *
+ * Для каждого размещения текущей фигуры перебираются размещения первой
+ * фигуры очереди; вариант оценивается по лучшему итоговому полю. Буферы
+ * поиска берутся из арены потока, куча в процессе поиска не используется.
+ * @param weights Веса оценочной функции
+ * @param move Указатель для сохранения размещения
+ * @return true если найдено хотя бы одно размещение
+ */
+bool aiFindMoveLookahead(const AiWeights_t *weights, AiMove_t *move);
+
+/**
+ * @brief Строит последовательность действий для размещения
+ * @param move Размещение, найденное aiFindMove
+ * @param actions Буфер для действий (не меньше AI_MAX_ACTIONS)
+ * @return Количество действий; последнее — Down
+ */
+int aiPlanActions(AiMove_t move, UserAction_t *actions);
+
+#endif  // AI_H
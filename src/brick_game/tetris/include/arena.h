@@ -0,0 +1,153 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tetris.h"
+
+#define ARENA_ALIGN 16                  // Выравнивание всех выделений
+#define THREAD_ARENA_SIZE (8u << 20)    // Размер арены потока, байт
+
+/**
+ * @brief Линейный (bump) аллокатор
+ *
+ * Память выделяется последовательно из одного блока и освобождается
+ * целиком: arenaReset за O(1) или arenaRelease до сохраненной отметки.
+ */
+typedef struct {
+  uint8_t *base;
+  size_t size;
+  size_t used;
+  size_t peak;  // Максимальное заполнение с момента создания
+  bool owned;   // Блок выделен самой ареной
+} Arena_t;
+
+/**
+ * @brief Пул блоков одинакового размера со списком свободных блоков
+ */
+typedef struct PoolBlock {
+  struct PoolBlock *next;
+} PoolBlock_t;
+
+typedef struct {
+  PoolBlock_t *free_list;
+  size_t block_size;
+  int capacity;
+  int used;
+} Pool_t;
+
+/**
+ * @brief Снимок игрового поля того же размера, что у игры
+ */
+typedef struct {
+  BoardRows_t rows;
+  Cell_t cells[FIELD_HEIGHT_MAX][FIELD_WIDTH_MAX];
+} BoardSnapshot_t;
+
+/**
+ * @brief Создает арену с собственным блоком памяти
+ * @param arena Арена
+ * @param size Размер блока в байтах
+ * @return true при успешном выделении
+ */
+bool arenaInit(Arena_t *arena, size_t size);
+
+/**
+ * @brief Создает арену поверх памяти вызывающего
+ * @param arena Арена
+ * @param buffer Память (выравнивается по ARENA_ALIGN)
+ * @param size Размер памяти в байтах
+ */
+void arenaInitBuffer(Arena_t *arena, void *buffer, size_t size);
+
+/**
+ * @brief Выделяет память из арены
+ * @param arena Арена
+ * @param size Размер в байтах
+ * @return Указатель, выровненный по ARENA_ALIGN, или NULL, если места нет
+ */
+void *arenaAlloc(Arena_t *arena, size_t size);
+
+/**
+ * @brief Возвращает отметку текущего заполнения
+ * @param arena Арена
+ * @return Отметка для arenaRelease
+ */
+size_t arenaMark(const Arena_t *arena);
+
+/**
+ * @brief Освобождает все выделенное после отметки
+ * @param arena Арена
+ * @param mark Отметка, полученная arenaMark
+ */
+void arenaRelease(Arena_t *arena, size_t mark);
+
+/**
+ * @brief Освобождает все выделения арены за O(1)
+ * @param arena Арена
+ */
+void arenaReset(Arena_t *arena);
+
+/**
+ * @brief Освобождает блок памяти арены
+ * @param arena Арена
+ */
+void arenaFree(Arena_t *arena);
+
+/**
+ * @brief Возвращает арену текущего потока
+ *
+ * Создается при первом вызове в потоке размером THREAD_ARENA_SIZE и
+ * освобождается при завершении потока.
+ * @return Арена или NULL, если память выделить не удалось
+ */
+Arena_t *threadArena();
+
+/**
+ * @brief Размечает пул из памяти арены
+ * @param pool Пул
+ * @param arena Арена-источник
+ * @param block_size Размер блока в байтах
+ * @param capacity Количество блоков
+ * @return true если в арене хватило места
+ */
+bool poolInit(Pool_t *pool, Arena_t *arena, size_t block_size, int capacity);
+
+/**
+ * @brief Берет блок из пула за O(1)
+ * @param pool Пул
+ * @return Блок или NULL, если пул исчерпан
+ */
+void *poolAlloc(Pool_t *pool);
+
+/**
+ * @brief Возвращает блок в пул за O(1)
+ * @param pool Пул
+ * @param block Блок, полученный poolAlloc
+ */
+void poolFree(Pool_t *pool, void *block);
+
+/**
+ * @brief Размечает пул снимков поля
+ * @param pool Пул
+ * @param arena Арена-источник
+ * @param capacity Количество снимков
+ * @return true если в арене хватило места
+ */
+bool boardPoolInit(Pool_t *pool, Arena_t *arena, int capacity);
+
+/**
+ * @brief Копирует игровое поле в снимок
+ * @param snapshot Снимок
+ */
+void captureBoard(BoardSnapshot_t *snapshot);
+
+/**
+ * @brief Восстанавливает игровое поле из снимка
+ * @param snapshot Снимок
+ */
+void restoreBoard(const BoardSnapshot_t *snapshot);
+
+#endif  // ARENA_H
@@ -0,0 +1,73 @@
+#ifndef EVAL_H
+#define EVAL_H
+
+#include <stdint.h>
+
+#include "tetris.h"
+
+#define BITBOARD_ROWS 24  // FIELD_HEIGHT, дополненное до кратного 8
+#define BITBOARD_FULL_ROW ((uint16_t)((1u << FIELD_WIDTH) - 1))
+
+/**
+ * @brief Битовое поле: бит x строки y — клетка (x, y)
+ *
+ * Строки FIELD_HEIGHT..BITBOARD_ROWS-1 служат выравниванием и не
+ * учитываются при оценке.
+ */
+typedef struct {
+  _Alignas(16) uint16_t rows[BITBOARD_ROWS];
+} Bitboard_t;
+
+/**
+ * @brief Признаки позиции
+ */
+typedef enum {
+  FEATURE_AGGREGATE_HEIGHT,    // Сумма высот столбцов
+  FEATURE_COMPLETE_LINES,      // Полностью заполненные строки
+  FEATURE_HOLES,               // Пустые клетки под заполненными
+  FEATURE_BUMPINESS,           // Сумма перепадов высот соседних столбцов
+  FEATURE_MAX_HEIGHT,          // Высота самого высокого столбца
+  FEATURE_ROW_TRANSITIONS,     // Смены пусто/занято по строкам (стены заняты)
+  FEATURE_COLUMN_TRANSITIONS,  // Смены пусто/занято по столбцам (дно занято)
+  FEATURE_WELL_CELLS,  // Открытые сверху клетки между занятыми соседями
+  FEATURE_COUNT
+} BoardFeature_t;
+
+/**
+ * @brief Вектор признаков одной позиции
+ */
+typedef struct {
+  int16_t values[FEATURE_COUNT];
+} BoardFeatures_t;
+
+/**
+ * @brief Строит битовое поле по матрице игрового поля
+ *
+ * Оценка рассчитана на поле размера по умолчанию.
+ * @param field Матрица FIELD_HEIGHT × FIELD_WIDTH
+ * @return Битовое поле
+ */
+Bitboard_t boardFromField(Cell_t (*field)[FIELD_WIDTH_MAX]);
+
+/**
+ * @brief Вычисляет признаки для пакета позиций
+ *
+ * Использует AVX2 (16 позиций за проход) или SSE2 (8 позиций), если их
+ * поддерживает процессор; остаток пакета и прочие платформы обрабатываются
+ * скалярным кодом. Результат не зависит от выбранного пути.
+ * @param boards Массив позиций
+ * @param count Количество позиций
+ * @param out Массив для признаков (count элементов)
+ */
+void evaluateBoards(const Bitboard_t *boards, int count, BoardFeatures_t *out);
+
+/**
+ * @brief Скалярная реализация evaluateBoards
+ * @param boards Массив позиций
+ * @param count Количество позиций
+ * @param out Массив для признаков (count элементов)
+ */
+void evaluateBoardsScalar(const Bitboard_t *boards, int count,
+                          BoardFeatures_t *out);
+
+#endif  // EVAL_H
@@ -0,0 +1,69 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <stdint.h>
+
+#define LEADERBOARD_FILE "leaderboard.dat"
+#define LEADERBOARD_MAGIC 0x31425254u  // "TRB1"
+#define LEADERBOARD_VERSION 1
+#define LEADERBOARD_CAPACITY 1024
+#define LEADERBOARD_PER_PLAYER 10
+#define LEADERBOARD_NAME_SIZE 16
+
+/**
+ * @brief Запись таблицы рекордов
+ */
+typedef struct {
+  char player[LEADERBOARD_NAME_SIZE];  // Имя игрока (с завершающим нулем)
+  int32_t score;                       // Счет
+  int32_t level;                       // Достигнутый уровень
+  int32_t lines;                       // Очищено линий
+  int32_t reserved;
+  int64_t timestamp;  // Время завершения игры (Unix time)
+} LeaderboardEntry_t;
+
+/**
+ * @brief Бинарный файл таблицы рекордов (отображается в память целиком)
+ *
+ * Записи отсортированы по убыванию счета, при равенстве — по времени
+ * добавления. У каждого игрока хранится не более LEADERBOARD_PER_PLAYER
+ * лучших результатов.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t count;
+  LeaderboardEntry_t entries[LEADERBOARD_CAPACITY];
+} LeaderboardFile_t;
+
+/**
+ * @brief Добавляет результат в таблицу рекордов
+ *
+ * Позиция ищется двоичным поиском за O(log n), но подсчет записей игрока и
+ * сдвиг хвоста таблицы линейны: вставка — O(n) по отображенной памяти не
+ * больше LEADERBOARD_CAPACITY записей, без перезаписи файла.
+ * @param path Путь к файлу таблицы (создается при отсутствии)
+ * @param entry Добавляемая запись
+ * @return Позиция записи в таблице или -1, если результат не попал в таблицу
+ * либо файл недоступен
+ */
+int leaderboardInsert(const char *path, const LeaderboardEntry_t *entry);
+
+/**
+ * @brief Читает таблицу рекордов
+ * @param path Путь к файлу таблицы
+ * @param out Буфер для записей
+ * @param max Размер буфера
+ * @return Количество прочитанных записей (0, если файла нет)
+ */
+int leaderboardRead(const char *path, LeaderboardEntry_t *out, int max);
+
+/**
+ * @brief Возвращает лучший счет из таблицы рекордов
+ * @param path Путь к файлу таблицы
+ * @return Лучший счет или 0, если таблица пуста
+ */
+int leaderboardBest(const char *path);
+
+#endif  // LEADERBOARD_H
@@ -0,0 +1,57 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include "tetris.h"
+
+/**
+ * @brief Итог размещения фигуры
+ */
+typedef struct {
+  Tetromino_t piece;  // Где фигура зафиксирована
+  int score;          // Прирост счета
+  int lines;          // Очищено линий
+  uint8_t rows[4];    // Индексы очищенных строк до сдвига поля
+} PlaceResult_t;
+
+/**
+ * @brief Размещает текущую фигуру в повороте и столбце одним вызовом
+ *
+ * Фигура поворачивается и сдвигается из текущего положения, если путь
+ * свободен; иначе достижимость проверяется поиском в ширину по сдвигам,
+ * поворотам и опусканию на строку. Из самого верхнего достижимого
+ * положения с заданными поворотом и столбцом фигура падает вниз и
+ * фиксируется, затем очищаются линии и появляется следующая фигура, как
+ * после сброса через userInput. Игровое время не идет.
+ * @param rotation Итоговый поворот 0..3
+ * @param x Итоговая координата X
+ * @param result Итог размещения или NULL
+ * @return false, если игра не ждет хода или положение недостижимо; игра
+ * тогда не меняется
+ */
+bool placePiece(int rotation, int x, PlaceResult_t *result);
+
+/**
+ * @brief Проводит текущую фигуру по пути и фиксирует ее
+ *
+ * Шаги пути: Left и Right — сдвиг на столбец, Action — поворот, Down —
+ * опускание на строку (а не сброс). После последнего шага фигура падает
+ * вниз и фиксируется, как в placePiece; так задаются подсечки и повороты
+ * под навесом.
+ * @param path Шаги
+ * @param count Количество шагов
+ * @param result Итог размещения или NULL
+ * @return false, если игра не ждет хода или шаг упирается в стену или
+ * блоки; игра тогда не меняется
+ */
+bool placePath(const UserAction_t *path, int count, PlaceResult_t *result);
+
+/**
+ * @brief Сбрасывает текущую фигуру с места, без выбора положения
+ *
+ * Запасной ход бота, когда подходящего размещения нет: фигура падает
+ * вниз, как после userInput(Down), а следующая появляется сразу. Игровое
+ * время не идет.
+ */
+void dropPiece(void);
+
+#endif  // PLACEMENT_H
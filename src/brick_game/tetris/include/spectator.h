@@ -0,0 +1,100 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tetris.h"
+
+#define SPECTATOR_FEED_NAME "/brickgame-tetris"  // Имя разделяемой памяти
+#define SPECTATOR_MAGIC 0x43455053u              // "SPEC"
+#define SPECTATOR_VERSION 1
+#define SPECTATOR_RING_SIZE 64  // Кадров в кольцевом буфере
+#define SPECTATOR_READ_RETRIES 16
+
+/**
+ * @brief Кадр трансляции
+ *
+ * Поле упаковано по строкам: бит x строки y — клетка (x, y).
+ */
+typedef struct {
+  uint64_t number;  // Порядковый номер кадра, начиная с 1
+  uint16_t rows[FIELD_HEIGHT];
+  int8_t piece;  // Тип текущей фигуры
+  int8_t rotation;
+  int8_t x, y;
+  int8_t next;   // Тип следующей фигуры
+  uint8_t state;  // GameState_t
+  uint8_t level;
+  uint8_t pause;
+  int32_t score;
+  int32_t high_score;
+} SpectatorFrame_t;
+
+/**
+ * @brief Слот кольцевого буфера под защитой seqlock
+ *
+ * Нечетный seq означает, что слот переписывается.
+ */
+typedef struct {
+  atomic_uint seq;
+  SpectatorFrame_t frame;
+} SpectatorSlot_t;
+
+/**
+ * @brief Содержимое разделяемой памяти трансляции
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  atomic_uint_least64_t head;  // Номер последнего опубликованного кадра
+  SpectatorSlot_t slots[SPECTATOR_RING_SIZE];
+} SpectatorFeed_t;
+
+/**
+ * @brief Создает трансляцию в разделяемой памяти
+ * @param name Имя объекта POSIX shared memory (начинается с '/')
+ * @return true при успехе
+ */
+bool spectatorOpen(const char *name);
+
+/**
+ * @brief Публикует текущее состояние игры, если оно изменилось
+ *
+ * Без открытой трансляции ничего не делает. Кадр трансляции рассчитан на
+ * поле FIELD_WIDTH × FIELD_HEIGHT; игра на другом поле не публикуется.
+ * Системных вызовов не выполняет.
+ * @return false, если трансляция открыта, а размер поля не поддерживается
+ */
+bool spectatorPublish();
+
+/**
+ * @brief Закрывает трансляцию и удаляет объект разделяемой памяти
+ */
+void spectatorClose();
+
+/**
+ * @brief Подключается к трансляции только для чтения
+ * @param name Имя объекта POSIX shared memory
+ * @return Трансляция или NULL, если она не найдена или несовместима
+ */
+const SpectatorFeed_t *spectatorAttach(const char *name);
+
+/**
+ * @brief Читает последний опубликованный кадр
+ *
+ * Чтение не блокирует игру: при конфликте с записью попытка повторяется.
+ * @param feed Трансляция
+ * @param frame Указатель для сохранения кадра
+ * @return true если кадр прочитан
+ */
+bool spectatorRead(const SpectatorFeed_t *feed, SpectatorFrame_t *frame);
+
+/**
+ * @brief Отключается от трансляции
+ * @param feed Трансляция, полученная spectatorAttach
+ */
+void spectatorDetach(const SpectatorFeed_t *feed);
+
+#endif  // SPECTATOR_H
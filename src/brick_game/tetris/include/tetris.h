@@ -2,43 +2,26 @@
 #define TETRIS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-#define FIELD_WIDTH 10
-#define FIELD_HEIGHT 20
-#define NEXT_SIZE 4
+#include "brick_game.h"
+#include "gameclock.h"
+#include "leaderboard.h"
+
 #define TETROMINO_COUNT 7
-#define HIGH_SCORE_FILE "high_score.txt"
+#define NEXT_QUEUE_MAX 6      // Максимальная длина очереди следующих фигур
+#define NEXT_QUEUE_DEFAULT 1  // Длина очереди по умолчанию
+#define EVENT_RING_SIZE 4096  // Должен быть степенью двойки
+#define HELD_NONE -1          // Ни одно действие не удерживается
 
-/**
- * @brief Перечисление действий пользователя
- */
-typedef enum {
-  Start,
-  Pause,
-  Terminate,
-  Left,
-  Right,
-  Up,
-  Down,
-  Action
-} UserAction_t;
-
-/**
- * @brief Структура с информацией о текущем состоянии игры
- */
-typedef struct {
-  int **field;     // Игровое поле (матрица)
-  int **next;      // Следующая фигура (матрица)
-  int score;       // Текущий счет
-  int high_score;  // Лучший счет
-  int level;       // Уровень игры
-  int speed;       // Скорость игры
-  int pause;       // Флаг паузы
-} GameInfo_t;
+// Клетка поля Tetris: тип зафиксированной фигуры + 1
+#define CELL_PIECE(type) ((Cell_t)((type) + 1))  // Клетка фигуры типа type
+#define CELL_TYPE(cell) ((int)(cell) - 1)        // Тип фигуры клетки
+#define CELL_GARBAGE CELL_PIECE(TETROMINO_COUNT)  // Клетка мусорной линии
 
 /**
  * @brief Перечисление состояний игры
@@ -62,31 +45,183 @@ typedef struct {
   int rotation;
 } Tetromino_t;
 
+/**
+ * @brief Занятость строк поля: бит x строки y — клетка (x, y) занята
+ *
+ * Слово строки — наименьшее, в которое помещается ширина поля.
+ */
+typedef union {
+  uint16_t rows16[FIELD_HEIGHT_MAX];
+  uint32_t rows32[FIELD_HEIGHT_MAX];
+  uint64_t rows64[FIELD_HEIGHT_MAX];
+} BoardRows_t;
+
+/**
+ * @brief Ядра поля, собранные под размер слова строки
+ *
+ * Работают с game текущего потока; выбираются один раз при задании
+ * размера поля (см. setFieldSize).
+ */
+typedef struct {
+  bool (*collides)(Tetromino_t tetromino);  // Фигура вне поля или на блоках
+  void (*place)(Tetromino_t tetromino);     // Фиксирует фигуру на поле
+  int (*clear)(uint8_t *rows);  // Очищает полные строки, до 4 индексов в rows
+  void (*sync)(int y);          // Пересчитывает биты строки по клеткам
+  int bits;                     // Размер слова строки
+} BoardKernels_t;
+
 /**
  * @brief Основная структура игры
  */
 typedef struct {
   GameState_t state;
-  GameInfo_t info;
+  GameInfo_t info;  // info.width × info.height — размер поля
+  const BoardKernels_t *kernels;
+  BoardRows_t rows;
   Tetromino_t current;
-  Tetromino_t next;
-  clock_t last_time;
+  int queue[NEXT_QUEUE_MAX];  // Кольцевой буфер типов следующих фигур
+  int queue_head;             // Индекс ближайшей следующей фигуры
+  int queue_length;           // Длина очереди (1..NEXT_QUEUE_MAX)
+  int64_t time_ms;    // Игровое время, мс
+  int64_t last_time;  // Время последнего шага гравитации, мс
+  // Отсчет гравитации остановлен паузой: с последнего шага прошло
+  // frozen_ms, и отсчет продолжится с первого шага времени после нее
+  bool frozen;
+  int64_t frozen_ms;
+  int held;           // Удерживаемое действие UserAction_t или HELD_NONE
+  int64_t repeat_at;  // Время следующего повтора удерживаемого действия, мс
+  int repeat_delay;     // Задержка автоповтора, мс; 0 — еще не задана
+  int repeat_interval;  // Интервал автоповтора, мс
   int lines_cleared;
+  int garbage_out;  // Мусорные линии для соперника, еще не отправленные
+  uint32_t rng_state;  // Состояние генератора фигур
+  uint64_t version;    // Растет при каждом изменении, см. engineVersion
+  // Поле; info.field указывает сюда. Последним, чтобы снимок копировал
+  // только строки поля
+  Cell_t cells[FIELD_HEIGHT_MAX][FIELD_WIDTH_MAX];
 } Game_t;
 
-// Основные функции API
 /**
- * @brief Обрабатывает пользовательский ввод
- * @param action Действие пользователя
- * @param hold Флаг удержания клавиши
+ * @brief Полный снимок игры: поле, фигуры, очередь, генератор и таймеры
+ *
+ * Game_t не содержит указателей на собственную память, кроме info.field,
+ * который восстанавливается при загрузке снимка, поэтому снимок — простая
+ * копия структуры без строк за высотой поля.
  */
-void userInput(UserAction_t action, bool hold);
+typedef Game_t GameSnapshot_t;
 
+#ifdef TETRIS_EVENTS
 /**
- * @brief Обновляет текущее состояние игры
+ * @brief Типы событий движка
+ */
+typedef enum {
+  EVENT_SPAWN,       // Появилась новая фигура
+  EVENT_MOVE,        // Фигура сдвинута (игроком или гравитацией)
+  EVENT_ROTATE,      // Фигура повернута
+  EVENT_PLACE,       // Фигура зафиксирована на поле
+  EVENT_LINE_CLEAR,  // Очищены линии
+  EVENT_LEVEL_UP,    // Повышен уровень
+  EVENT_GAME_OVER    // Игра окончена
+} GameEventType_t;
+
+/**
+ * @brief Запись события фиксированного размера (16 байт)
+ */
+typedef struct {
+  uint8_t type;      // GameEventType_t
+  uint8_t piece;     // Тип фигуры
+  uint8_t rotation;  // Поворот фигуры
+  uint8_t count;     // Число очищенных линий или новый уровень
+  int8_t x, y;       // Позиция фигуры
+  uint8_t rows[4];   // Индексы очищенных строк (до сдвига поля)
+  uint8_t reserved[2];
+  int32_t score;  // Счет после события
+} GameEvent_t;
+
+/**
+ * @brief Кольцевой буфер событий
+ */
+typedef struct {
+  GameEvent_t events[EVENT_RING_SIZE];
+  uint64_t head;     // Количество записанных событий
+  uint64_t tail;     // Количество прочитанных событий
+  uint64_t dropped;  // События, потерянные при переполнении
+} GameEventRing_t;
+
+/**
+ * @brief Забирает накопленные события движка
+ * @param out Буфер для событий
+ * @param max Размер буфера
+ * @return Количество скопированных событий
+ */
+int pollGameEvents(GameEvent_t *out, int max);
+
+/**
+ * @brief Буфер событий (свой в каждом потоке)
+ */
+extern _Thread_local GameEventRing_t game_events;
+#endif
+
+// Основные функции API сверх общих из brick_game.h; игровое время
+// updateCurrentState берется из часов потока (см. setGameClock)
+/**
+ * @brief Продвигает игру на фиксированный шаг без обращения к часам
+ *
+ * Результат зависит только от состояния игры и ввода, поэтому
+ * симуляцию можно повторить с любого снимка.
+ * @param ms Длительность шага, мс
  * @return Структура с информацией о текущем состоянии игры
  */
-GameInfo_t updateCurrentState();
+GameInfo_t stepGame(int ms);
+
+/**
+ * @brief Сохраняет снимок текущей игры
+ * @param snapshot Указатель для сохранения
+ */
+void saveSnapshot(GameSnapshot_t *snapshot);
+
+/**
+ * @brief Восстанавливает игру из снимка
+ * @param snapshot Снимок, сохраненный saveSnapshot
+ */
+void loadSnapshot(const GameSnapshot_t *snapshot);
+
+/**
+ * @brief Копирует снимок игры
+ *
+ * Как saveSnapshot, копирует только строки текущей высоты поля, а не
+ * весь sizeof(Game_t).
+ * @param to Куда
+ * @param from Откуда
+ */
+void copySnapshot(GameSnapshot_t *to, const GameSnapshot_t *from);
+
+/**
+ * @brief Размер снимка игры с полем высоты height
+ *
+ * Снимки полей одной высоты можно хранить подряд с этим шагом (округленным
+ * до _Alignof(Game_t)) вместо sizeof(Game_t).
+ * @param height Высота поля
+ * @return Байт
+ */
+size_t gameSnapshotSize(int height);
+
+/**
+ * @brief Возвращает число мусорных линий за очистку
+ * @param lines Количество очищенных линий
+ * @return 0, 0, 1, 2 или 4 мусорные линии за 0–4 линии
+ */
+int garbageForLines(int lines);
+
+/**
+ * @brief Добавляет мусорные линии снизу поля
+ *
+ * Поле сдвигается вверх; если занятые клетки выходят за верх поля или
+ * текущей фигуре некуда сдвинуться вверх, игра заканчивается.
+ * @param lines Количество линий
+ * @param hole Столбец без блока
+ */
+void addGarbage(int lines, int hole);
 
 // Вспомогательные функции
 /**
@@ -94,6 +229,60 @@ GameInfo_t updateCurrentState();
  */
 void initGame();
 
+/**
+ * @brief Задает зерно генератора фигур
+ *
+ * Очередь фигур, уже сгенерированная initGame, не меняется; для
+ * воспроизводимой игры после seedGame нужно вызвать resetGame.
+ * @param seed Зерно
+ */
+void seedGame(uint32_t seed);
+
+/**
+ * @brief Задает автоповтор удерживаемых сдвигов
+ *
+ * Удержание Left/Right сдвигает фигуру сразу и затем повторяет сдвиг через
+ * delay_ms и далее каждые interval_ms игрового времени; удержание Down —
+ * мягкое падение на строку сразу и каждые interval_ms. Настройка
+ * сохраняется при перезапуске игры.
+ * @param delay_ms Задержка первого повтора, мс (не меньше 1)
+ * @param interval_ms Интервал повторов, мс (не меньше 1)
+ */
+void setAutoRepeat(int delay_ms, int interval_ms);
+
+/**
+ * @brief Задает размер поля и начинает новую игру
+ * @param width Ширина FIELD_SIZE_MIN..FIELD_WIDTH_MAX
+ * @param height Высота FIELD_SIZE_MIN..FIELD_HEIGHT_MAX
+ * @return false при неверном размере; игра тогда не меняется
+ */
+bool setFieldSize(int width, int height);
+
+/**
+ * @brief Возвращает ядра поля для ширины
+ * @param width Ширина поля 1..FIELD_WIDTH_MAX
+ * @return Ядра с наименьшим словом строки, вмещающим ширину
+ */
+const BoardKernels_t *boardKernels(int width);
+
+/**
+ * @brief Записывает клетку поля вместе с битом занятости строки
+ *
+ * Клетки поля меняются только через движок или эту функцию.
+ * @param x Столбец
+ * @param y Строка
+ * @param cell Клетка
+ */
+void setCell(int x, int y, Cell_t cell);
+
+/**
+ * @brief Начинает новую игру в уже выделенных буферах
+ *
+ * Не выделяет память, не читает таблицу рекордов и не переинициализирует
+ * генератор случайных чисел.
+ */
+void resetGame();
+
 /**
  * @brief Освобождает память игры
  */
@@ -126,6 +315,13 @@ void placeTetromino(Tetromino_t tetromino);
  */
 void clearLines();
 
+/**
+ * @brief Очищает заполненные линии, как clearLines, и сообщает какие
+ * @param rows Буфер на 4 индекса строк до сдвига поля
+ * @return Количество очищенных линий
+ */
+int clearFullLines(uint8_t *rows);
+
 /**
  * @brief Создает новое тетромино
  */
@@ -155,15 +351,41 @@ void dropTetromino();
 void updateScore(int lines);
 
 /**
- * @brief Сохраняет лучший результат
+ * @brief Задает длину очереди следующих фигур
+ * @param length Количество фигур (ограничивается диапазоном 1..NEXT_QUEUE_MAX)
  */
-void saveHighScore();
+void setNextQueueLength(int length);
 
 /**
- * @brief Загружает лучший результат
+ * @brief Возвращает тип фигуры из очереди следующих
+ * @param index Позиция в очереди (0 — ближайшая)
+ * @return Тип тетромино или -1 при неверном индексе
+ */
+int peekNextPiece(int index);
+
+/**
+ * @brief Возвращает готовую матрицу превью фигуры
+ * @param type Тип тетромино
+ * @return Матрица NEXT_SIZE × NEXT_SIZE (только для чтения) или NULL
+ */
+int **getPreview(int type);
+
+/**
+ * @brief Загружает лучший результат из таблицы рекордов
  */
 void loadHighScore();
 
+/**
+ * @brief Записывает результат текущей игры в таблицу рекордов
+ */
+void recordGameResult();
+
+/**
+ * @brief Задает файл таблицы рекордов
+ * @param path Путь к файлу или NULL, чтобы не сохранять результаты
+ */
+void setLeaderboardFile(const char *path);
+
 /**
  * @brief Получает блок тетромино
  * @param type Тип тетромино
@@ -176,7 +398,10 @@ int getTetrominoBlock(int type, int rotation, int x, int y);
 
 /**
  * @brief Глобальная переменная игры
+ *
+ * У каждого потока свой экземпляр, поэтому независимые игры можно вести
+ * параллельно в разных потоках.
  */
-extern Game_t game;
+extern _Thread_local Game_t game;
 
 #endif  // TETRIS_H
\ No newline at end of file
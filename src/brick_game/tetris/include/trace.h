@@ -0,0 +1,50 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+
+#define TRACE_FILE "tetris_trace.json"  // Файл трассы по умолчанию
+#define TRACE_BUFFER_SIZE 65536         // Последних событий на поток
+
+/**
+ * @brief Границы участков для трассировки (make TRACE=1)
+ *
+ * Без TETRIS_TRACE макросы не порождают кода.
+ */
+#ifdef TETRIS_TRACE
+#define TRACE_BEGIN(name) traceRecord(name, 'B')
+#define TRACE_END(name) traceRecord(name, 'E')
+#else
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name) ((void)0)
+#endif
+
+/**
+ * @brief Записывает границу участка в буфер текущего потока
+ *
+ * Каждый поток пишет только в свое кольцо, поэтому запись не требует
+ * блокировок. Кольцо хранит последние TRACE_BUFFER_SIZE событий потока:
+ * при переполнении затираются самые старые, и трасса долгой игры
+ * показывает ее конец.
+ * @param name Имя участка (строка со статическим временем жизни)
+ * @param phase 'B' — начало, 'E' — конец
+ */
+void traceRecord(const char *name, char phase);
+
+/**
+ * @brief Сохраняет трассу всех потоков в формате Chrome trace JSON
+ *
+ * Файл открывается в Perfetto или chrome://tracing. Вызывать после
+ * завершения потоков, пишущих в трассу.
+ * @param path Путь к файлу
+ * @return Количество записанных событий или -1 при ошибке
+ */
+long traceWrite(const char *path);
+
+/**
+ * @brief Возвращает число событий, затертых при переполнении колец
+ * @return Сумма по всем потокам
+ */
+size_t traceDropped();
+
+#endif  // TRACE_H
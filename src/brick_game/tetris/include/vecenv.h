@@ -0,0 +1,100 @@
+#ifndef VECENV_H
+#define VECENV_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <threads.h>
+
+#include "tetris.h"
+
+#define VECENV_MAX_THREADS 64
+#define VECENV_STEP_MS 16  // Игровое время одного шага по умолчанию, мс
+#define VECENV_NOOP (-1)   // Действие «ничего не делать»
+#define VECENV_PIECE_FIELDS 5  // Тип, поворот, x, y текущей фигуры и следующая
+#define VECENV_WIDTH_MAX 16  // Строки такой ширины ядра ведут в 16 битах
+
+/**
+ * @brief Буферы наблюдений, которыми владеет вызывающий
+ *
+ * Массивы непрерывные, первая размерность — номер игры; height и width —
+ * размер поля набора. Буфер, равный NULL, не заполняется.
+ */
+typedef struct {
+  Cell_t *boards;    // [count][height][width]: клетки без фигуры
+  uint16_t *rows;    // [count][height]: бит x — клетка x строки занята
+  int8_t *pieces;    // [count][VECENV_PIECE_FIELDS]
+  int32_t *rewards;  // [count]: прирост счета за шаг
+  uint8_t *dones;    // [count]: 1 — игра закончилась и начата заново
+} VecEnvObs_t;
+
+/**
+ * @brief Набор независимых игр, которые делают шаг одним вызовом
+ *
+ * Игры хранятся подряд снимками gameSnapshotSize(height) байт, без строк за
+ * высотой поля, и по очереди подставляются в game потока, который их
+ * считает. Потоки-исполнители создаются один раз в vecEnvInit; шаг не
+ * выделяет память и не создает потоков.
+ */
+typedef struct {
+  unsigned char *games;
+  size_t game_size;  // Шаг снимков в games, байт
+  int count;
+  int width, height;  // Размер поля всех игр
+  int step_ms;  // Игровое время одного шага, мс
+  int threads;  // Всего потоков, включая вызывающий
+  thrd_t workers[VECENV_MAX_THREADS - 1];
+  mtx_t lock;
+  cnd_t start;  // Новый шаг для исполнителей
+  cnd_t done;   // Все исполнители закончили шаг
+  uint64_t generation;
+  int pending;
+  bool stopping;
+  const int8_t *actions;  // Задание текущего шага
+  const VecEnvObs_t *obs;
+} VecEnv_t;
+
+/**
+ * @brief Создает count игр на поле width × height и потоки-исполнители
+ *
+ * Игра i начинается с зерна seed + i, поэтому прогон воспроизводим при
+ * любом числе потоков. Закончившаяся игра сразу начинается заново.
+ * Отключает таблицу рекордов процесса (setLeaderboardFile(NULL)): результаты
+ * игр набора не записываются.
+ * @param env Набор
+ * @param count Количество игр
+ * @param width Ширина поля FIELD_SIZE_MIN..VECENV_WIDTH_MAX
+ * @param height Высота поля FIELD_SIZE_MIN..FIELD_HEIGHT_MAX
+ * @param threads Количество потоков (1..VECENV_MAX_THREADS)
+ * @param seed Зерно фигур первой игры
+ * @return true при успехе
+ */
+bool vecEnvInit(VecEnv_t *env, int count, int width, int height, int threads,
+                uint32_t seed);
+
+/**
+ * @brief Делает шаг во всех играх
+ *
+ * Игра i получает действие actions[i] (UserAction_t из Left, Right, Up,
+ * Down, Action или VECENV_NOOP; остальные значения пропускаются), после
+ * чего ее время продвигается на step_ms. Глобальная game вызывающего потока
+ * не меняется.
+ * @param env Набор
+ * @param actions Действия, count штук
+ * @param obs Буферы наблюдений после шага
+ */
+void vecEnvStep(VecEnv_t *env, const int8_t *actions, const VecEnvObs_t *obs);
+
+/**
+ * @brief Заполняет наблюдения без шага
+ * @param env Набор
+ * @param obs Буферы наблюдений
+ */
+void vecEnvObserve(const VecEnv_t *env, const VecEnvObs_t *obs);
+
+/**
+ * @brief Останавливает потоки и освобождает игры
+ * @param env Набор
+ */
+void vecEnvFree(VecEnv_t *env);
+
+#endif  // VECENV_H
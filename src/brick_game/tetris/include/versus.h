@@ -0,0 +1,153 @@
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tetris.h"
+
+#define VERSUS_TICK_MS 16       // Шаг симуляции, мс
+#define VERSUS_MAX_ROLLBACK 16  // Максимальное опережение удаленного ввода
+#define VERSUS_HISTORY 32       // Глубина истории; степень двойки
+#define VERSUS_LOCAL 0
+#define VERSUS_REMOTE 1
+#define VERSUS_DRAW 2
+#define VERSUS_PACKET_SIZE 5  // Тик (4 байта, little-endian) и ввод
+
+_Static_assert(VERSUS_HISTORY >= VERSUS_MAX_ROLLBACK + 1 &&
+                   (VERSUS_HISTORY & (VERSUS_HISTORY - 1)) == 0,
+               "History must cover the rollback window");
+
+/**
+ * @brief Ввод игрока за один тик: бит (1 << UserAction_t) на действие
+ */
+typedef uint8_t VersusInput_t;
+
+/**
+ * @brief Сессия игры вдвоем с откатом
+ *
+ * Удаленный ввод, который еще не пришел, предсказывается пустым. Если
+ * пришедший ввод расходится с предсказанием, обе игры восстанавливаются
+ * из снимка того тика и симуляция повторяется до текущего тика.
+ */
+typedef struct {
+  Game_t games[2];  // VERSUS_LOCAL и VERSUS_REMOTE
+  uint32_t seeds[2];  // Зерна фигур игроков; от них зависит мусор
+  int64_t tick;     // Номер следующего тика симуляции
+  int64_t confirmed;  // Удаленный ввод известен для всех тиков < confirmed
+  VersusInput_t inputs[2][VERSUS_HISTORY];
+  GameSnapshot_t snapshots[VERSUS_HISTORY][2];  // Состояние перед тиком
+  int64_t rollbacks;    // Число откатов
+  int64_t resimulated;  // Число повторно просчитанных тиков
+} VersusSession_t;
+
+/**
+ * @brief Буфер приема пакетов ввода из сокета
+ */
+typedef struct {
+  int fd;
+  uint8_t buffer[256];
+  int length;
+} VersusLink_t;
+
+/**
+ * @brief Начинает игру вдвоем
+ *
+ * Перед игрой вдвоем стоит отключить таблицу рекордов вызовом
+ * setLeaderboardFile(NULL): при откате конец игры может просчитываться
+ * повторно.
+ * @param session Сессия
+ * @param local_seed Зерно фигур локального игрока
+ * @param remote_seed Зерно фигур удаленного игрока
+ */
+void versusInit(VersusSession_t *session, uint32_t local_seed,
+                uint32_t remote_seed);
+
+/**
+ * @brief Проверяет, можно ли просчитать следующий тик
+ * @param session Сессия
+ * @return false если удаленный ввод отстает на VERSUS_MAX_ROLLBACK тиков
+ */
+bool versusCanAdvance(const VersusSession_t *session);
+
+/**
+ * @brief Просчитывает следующий тик с локальным вводом
+ * @param session Сессия
+ * @param input Локальный ввод за тик
+ * @return true если тик просчитан
+ */
+bool versusAdvance(VersusSession_t *session, VersusInput_t input);
+
+/**
+ * @brief Принимает удаленный ввод за тик
+ *
+ * Ввод должен приходить по порядку тиков. При расхождении с предсказанием
+ * выполняется откат и повторная симуляция.
+ * @param session Сессия
+ * @param tick Номер тика
+ * @param input Ввод за тик
+ * @return false если ввод пришел не по порядку
+ */
+bool versusRemoteInput(VersusSession_t *session, int64_t tick,
+                       VersusInput_t input);
+
+/**
+ * @brief Определяет победителя
+ *
+ * Учитываются только тики с подтвержденным удаленным вводом, поэтому
+ * результат не меняется после отката.
+ * @param session Сессия
+ * @return VERSUS_LOCAL, VERSUS_REMOTE, VERSUS_DRAW или -1, если игра
+ * продолжается
+ */
+int versusWinner(const VersusSession_t *session);
+
+/**
+ * @brief Загружает игру одного из игроков в game потока для отрисовки
+ * @param session Сессия
+ * @param player VERSUS_LOCAL или VERSUS_REMOTE
+ * @return Состояние загруженной игры
+ */
+GameInfo_t versusView(const VersusSession_t *session, int player);
+
+/**
+ * @brief Ожидает соперника на локальном сокете
+ * @param path Путь к UNIX-сокету
+ * @return Дескриптор соединения или -1
+ */
+int versusListen(const char *path);
+
+/**
+ * @brief Подключается к сопернику через локальный сокет
+ * @param path Путь к UNIX-сокету
+ * @return Дескриптор соединения или -1
+ */
+int versusConnect(const char *path);
+
+/**
+ * @brief Обменивается зернами фигур с соперником
+ * @param fd Дескриптор соединения
+ * @param seed Свое зерно
+ * @param remote_seed Указатель для зерна соперника
+ * @return true при успехе
+ */
+bool versusHandshake(int fd, uint32_t seed, uint32_t *remote_seed);
+
+/**
+ * @brief Отправляет ввод за тик сопернику
+ * @param link Соединение
+ * @param tick Номер тика
+ * @param input Ввод
+ * @return true при успехе
+ */
+bool versusSendInput(VersusLink_t *link, int64_t tick, VersusInput_t input);
+
+/**
+ * @brief Принимает все пришедшие пакеты ввода без блокировки
+ * @param link Соединение
+ * @param session Сессия, в которую передается ввод
+ * @return Количество пакетов или -1, если соединение разорвано
+ */
+int versusPollInputs(VersusLink_t *link, VersusSession_t *session);
+
+#endif  // VERSUS_H
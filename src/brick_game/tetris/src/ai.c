@@ -0,0 +1,241 @@
+#include "ai.h"
+
+#include <float.h>
+#include <threads.h>
+
+#include "arena.h"
+
+// Веса подобраны генетическим алгоритмом для классического поля 10×20
+const AiWeights_t ai_default_weights = {
+    {-0.510066, 0.760666, -0.35663, -0.184483, 0.0, 0.0, 0.0, 0.0}};
+
+/**
+ * @brief Битовое представление фигуры: бит x строки — столбец x матрицы 4×4
+ */
+typedef struct {
+  uint16_t rows[4];
+  int min_x, max_x;  // Крайние занятые столбцы матрицы
+} PieceMask_t;
+
+static PieceMask_t piece_masks[TETROMINO_COUNT][4];
+static once_flag piece_masks_once = ONCE_FLAG_INIT;
+
+static void buildPieceMasks() {
+  for (int type = 0; type < TETROMINO_COUNT; type++) {
+    for (int rotation = 0; rotation < 4; rotation++) {
+      PieceMask_t mask = {{0}, 4, -1};
+      for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+          if (getTetrominoBlock(type, rotation, x, y)) {
+            mask.rows[y] |= (uint16_t)(1u << x);
+            if (x < mask.min_x) mask.min_x = x;
+            if (x > mask.max_x) mask.max_x = x;
+          }
+        }
+      }
+      piece_masks[type][rotation] = mask;
+    }
+  }
+}
+
+static uint16_t shiftRow(uint16_t row, int x) {
+  return (uint16_t)(x >= 0 ? row << x : row >> -x);
+}
+
+static bool collides(const Bitboard_t *board, const PieceMask_t *piece, int x,
+                     int y) {
+  if (x + piece->min_x < 0 || x + piece->max_x >= FIELD_WIDTH) return true;
+  for (int r = 0; r < 4; r++) {
+    if (piece->rows[r]) {
+      int row = y + r;
+      if (row >= FIELD_HEIGHT) return true;
+      if (row >= 0 && (board->rows[row] & shiftRow(piece->rows[r], x))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Фиксирует фигуру на копии поля и очищает линии; возвращает их число
+static int placeOnBoard(const Bitboard_t *board, const PieceMask_t *piece,
+                        int x, int y, Bitboard_t *result) {
+  *result = *board;
+  uint16_t *rows = result->rows;
+  for (int r = 0; r < 4; r++) {
+    if (piece->rows[r] && y + r >= 0) {
+      rows[y + r] |= shiftRow(piece->rows[r], x);
+    }
+  }
+
+  // Очищаем заполненные строки, сдвигая оставшиеся вниз
+  int lines = 0;
+  for (int src = FIELD_HEIGHT - 1, dst = FIELD_HEIGHT - 1; src >= 0; src--) {
+    if (rows[src] == BITBOARD_FULL_ROW) {
+      lines++;
+    } else {
+      rows[dst--] = rows[src];
+    }
+  }
+  for (int i = 0; i < lines; i++) rows[i] = 0;
+  return lines;
+}
+
+/**
+ * @brief Размещение фигуры, найденное перебором
+ */
+typedef struct {
+  int rotation;
+  int x;
+  int lines;  // Очищено линий этим размещением
+} Placement_t;
+
+// Перебирает размещения, достижимые поворотом на месте появления, сдвигом и
+// сбросом; поля после размещения пишутся в boards. Возвращает их число
+static int collectPlacements(const Bitboard_t *board, Tetromino_t cur,
+                             Bitboard_t *boards, Placement_t *placements) {
+  int count = 0;
+
+  // Повороты выполняются на месте появления по одному, как в canRotate
+  for (int turns = 0; turns < 4; turns++) {
+    int rotation = (cur.rotation + turns) % 4;
+    const PieceMask_t *piece = &piece_masks[cur.type][rotation];
+    if (collides(board, piece, cur.x, cur.y)) break;
+
+    for (int dir = -1; dir <= 1; dir += 2) {
+      // Позицию без сдвига учитываем только при движении влево
+      for (int x = dir < 0 ? cur.x : cur.x + 1;
+           !collides(board, piece, x, cur.y); x += dir) {
+        int y = cur.y;
+        while (!collides(board, piece, x, y + 1)) y++;
+        placements[count].lines = placeOnBoard(board, piece, x, y,
+                                               &boards[count]);
+        placements[count].rotation = rotation;
+        placements[count].x = x;
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+static double scoreFeatures(const AiWeights_t *weights,
+                            BoardFeatures_t *features, int lines) {
+  features->values[FEATURE_COMPLETE_LINES] = (int16_t)lines;
+  double score = 0.0;
+  for (int f = 0; f < FEATURE_COUNT; f++) {
+    score += weights->weights[f] * features->values[f];
+  }
+  return score;
+}
+
+// Битовые поля оценки рассчитаны на поле размера по умолчанию
+static bool defaultField() {
+  return game.info.width == FIELD_WIDTH && game.info.height == FIELD_HEIGHT;
+}
+
+int aiListMoves(const AiWeights_t *weights, AiMove_t *moves) {
+  if (!defaultField()) return 0;
+  call_once(&piece_masks_once, buildPieceMasks);
+
+  Bitboard_t board = boardFromField(game.cells);
+
+  // Собираем все достижимые размещения и оцениваем их одним пакетом
+  Bitboard_t candidates[AI_MAX_CANDIDATES];
+  BoardFeatures_t features[AI_MAX_CANDIDATES];
+  Placement_t placements[AI_MAX_CANDIDATES];
+  int count = collectPlacements(&board, game.current, candidates, placements);
+
+  evaluateBoards(candidates, count, features);
+
+  for (int i = 0; i < count; i++) {
+    moves[i].rotation = placements[i].rotation;
+    moves[i].x = placements[i].x;
+    moves[i].score =
+        scoreFeatures(weights, &features[i], placements[i].lines);
+  }
+  return count;
+}
+
+bool aiFindMove(const AiWeights_t *weights, AiMove_t *move) {
+  AiMove_t moves[AI_MAX_CANDIDATES];
+  int count = aiListMoves(weights, moves);
+  move->score = -DBL_MAX;
+  for (int i = 0; i < count; i++) {
+    if (moves[i].score > move->score) *move = moves[i];
+  }
+  return count > 0;
+}
+
+bool aiFindMoveLookahead(const AiWeights_t *weights, AiMove_t *move) {
+  if (!defaultField()) return false;
+  int next_type = peekNextPiece(0);
+  Arena_t *arena = threadArena();
+  if (next_type < 0 || !arena) return aiFindMove(weights, move);
+  call_once(&piece_masks_once, buildPieceMasks);
+
+  // Все буферы поиска берутся из арены потока и возвращаются ей целиком
+  size_t mark = arenaMark(arena);
+  const int max_leaves = AI_MAX_CANDIDATES * AI_MAX_CANDIDATES;
+  Bitboard_t *first = arenaAlloc(arena, sizeof(Bitboard_t) * AI_MAX_CANDIDATES);
+  Placement_t *first_moves =
+      arenaAlloc(arena, sizeof(Placement_t) * AI_MAX_CANDIDATES);
+  Bitboard_t *leaves = arenaAlloc(arena, sizeof(Bitboard_t) * max_leaves);
+  Placement_t *leaf_moves = arenaAlloc(arena, sizeof(Placement_t) * max_leaves);
+  BoardFeatures_t *features =
+      arenaAlloc(arena, sizeof(BoardFeatures_t) * max_leaves);
+  int *leaf_starts = arenaAlloc(arena, sizeof(int) * (AI_MAX_CANDIDATES + 1));
+  if (!first || !first_moves || !leaves || !leaf_moves || !features ||
+      !leaf_starts) {
+    arenaRelease(arena, mark);
+    return aiFindMove(weights, move);
+  }
+
+  Bitboard_t board = boardFromField(game.cells);
+  int count = collectPlacements(&board, game.current, first, first_moves);
+
+  // Размещения следующей фигуры для всех вариантов текущей собираются в
+  // один пакет, чтобы оценка шла полными векторами
+  Tetromino_t next = {FIELD_WIDTH / 2 - 2, 0, next_type, 0};
+  int leaf_count = 0;
+  for (int i = 0; i < count; i++) {
+    leaf_starts[i] = leaf_count;
+    leaf_count += collectPlacements(&first[i], next, &leaves[leaf_count],
+                                    &leaf_moves[leaf_count]);
+  }
+  leaf_starts[count] = leaf_count;
+
+  evaluateBoards(leaves, leaf_count, features);
+
+  move->score = -DBL_MAX;
+  for (int i = 0; i < count; i++) {
+    // Если следующая фигура не помещается, вариант ведет к концу игры
+    double best = -DBL_MAX / 2;
+    for (int j = leaf_starts[i]; j < leaf_starts[i + 1]; j++) {
+      double score = scoreFeatures(weights, &features[j],
+                                   first_moves[i].lines + leaf_moves[j].lines);
+      if (score > best) best = score;
+    }
+    if (best > move->score) {
+      move->rotation = first_moves[i].rotation;
+      move->x = first_moves[i].x;
+      move->score = best;
+    }
+  }
+
+  arenaRelease(arena, mark);
+  return count > 0;
+}
+
+int aiPlanActions(AiMove_t move, UserAction_t *actions) {
+  int count = 0;
+  int turns = (move.rotation - game.current.rotation + 4) % 4;
+  for (int i = 0; i < turns; i++) actions[count++] = Action;
+
+  int dx = move.x - game.current.x;
+  for (int i = 0; i < abs(dx) && count < AI_MAX_ACTIONS - 1; i++) {
+    actions[count++] = dx < 0 ? Left : Right;
+  }
+  actions[count++] = Down;
+  return count;
+}
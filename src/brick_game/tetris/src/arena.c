@@ -0,0 +1,133 @@
+#include "arena.h"
+
+#include <threads.h>
+
+static size_t alignUp(size_t value) {
+  return (value + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+bool arenaInit(Arena_t *arena, size_t size) {
+  size = alignUp(size);
+  arena->base = aligned_alloc(ARENA_ALIGN, size);
+  arena->size = arena->base ? size : 0;
+  arena->used = 0;
+  arena->peak = 0;
+  arena->owned = true;
+  return arena->base != NULL;
+}
+
+void arenaInitBuffer(Arena_t *arena, void *buffer, size_t size) {
+  uintptr_t start = (uintptr_t)buffer;
+  size_t skip = alignUp(start) - start;
+  arena->base = (uint8_t *)buffer + (skip < size ? skip : size);
+  arena->size = skip < size ? (size - skip) & ~(size_t)(ARENA_ALIGN - 1) : 0;
+  arena->used = 0;
+  arena->peak = 0;
+  arena->owned = false;
+}
+
+void *arenaAlloc(Arena_t *arena, size_t size) {
+  size = alignUp(size ? size : 1);
+  if (size > arena->size - arena->used) return NULL;
+
+  void *block = arena->base + arena->used;
+  arena->used += size;
+  if (arena->used > arena->peak) arena->peak = arena->used;
+  return block;
+}
+
+size_t arenaMark(const Arena_t *arena) { return arena->used; }
+
+void arenaRelease(Arena_t *arena, size_t mark) {
+  if (mark <= arena->used) arena->used = mark;
+}
+
+void arenaReset(Arena_t *arena) { arena->used = 0; }
+
+void arenaFree(Arena_t *arena) {
+  if (arena->owned) free(arena->base);
+  arena->base = NULL;
+  arena->size = arena->used = 0;
+}
+
+static tss_t thread_arena_key;
+static once_flag thread_arena_once = ONCE_FLAG_INIT;
+
+static void destroyThreadArena(void *ptr) {
+  Arena_t *arena = ptr;
+  arenaFree(arena);
+  free(arena);
+}
+
+static void createThreadArenaKey() {
+  tss_create(&thread_arena_key, destroyThreadArena);
+}
+
+Arena_t *threadArena() {
+  call_once(&thread_arena_once, createThreadArenaKey);
+  Arena_t *arena = tss_get(thread_arena_key);
+  if (!arena) {
+    arena = malloc(sizeof(Arena_t));
+    if (arena && !arenaInit(arena, THREAD_ARENA_SIZE)) {
+      free(arena);
+      arena = NULL;
+    }
+    if (arena) tss_set(thread_arena_key, arena);
+  }
+  return arena;
+}
+
+bool poolInit(Pool_t *pool, Arena_t *arena, size_t block_size, int capacity) {
+  if (block_size < sizeof(PoolBlock_t)) block_size = sizeof(PoolBlock_t);
+  block_size = alignUp(block_size);
+
+  uint8_t *blocks = capacity > 0 ? arenaAlloc(arena, block_size * capacity)
+                                 : NULL;
+  pool->free_list = NULL;
+  pool->block_size = block_size;
+  pool->capacity = blocks ? capacity : 0;
+  pool->used = 0;
+
+  // Список свободных блоков идет в порядке адресов
+  for (int i = pool->capacity - 1; i >= 0; i--) {
+    PoolBlock_t *block = (PoolBlock_t *)(blocks + (size_t)i * block_size);
+    block->next = pool->free_list;
+    pool->free_list = block;
+  }
+  return blocks != NULL;
+}
+
+void *poolAlloc(Pool_t *pool) {
+  PoolBlock_t *block = pool->free_list;
+  if (block) {
+    pool->free_list = block->next;
+    pool->used++;
+  }
+  return block;
+}
+
+void poolFree(Pool_t *pool, void *block) {
+  if (block) {
+    PoolBlock_t *node = block;
+    node->next = pool->free_list;
+    pool->free_list = node;
+    pool->used--;
+  }
+}
+
+bool boardPoolInit(Pool_t *pool, Arena_t *arena, int capacity) {
+  return poolInit(pool, arena, sizeof(BoardSnapshot_t), capacity);
+}
+
+// Копируются только строки поля
+void captureBoard(BoardSnapshot_t *snapshot) {
+  snapshot->rows = game.rows;
+  memcpy(snapshot->cells, game.cells,
+         (size_t)game.info.height * sizeof(game.cells[0]));
+}
+
+void restoreBoard(const BoardSnapshot_t *snapshot) {
+  game.rows = snapshot->rows;
+  memcpy(game.cells, snapshot->cells,
+         (size_t)game.info.height * sizeof(game.cells[0]));
+}
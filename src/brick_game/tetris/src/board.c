@@ -0,0 +1,150 @@
+#include <threads.h>
+
+#include "tetris.h"
+
+/**
+ * @brief Строки фигуры в одном повороте
+ */
+typedef struct {
+  uint8_t rows[4];      // Бит x — блок в столбце x матрицы 4×4
+  int8_t min_x, max_x;  // Крайние столбцы блоков
+  int8_t min_y, max_y;  // Крайние строки блоков
+} PieceRows_t;
+
+static PieceRows_t pieces[TETROMINO_COUNT][4];
+static once_flag pieces_once = ONCE_FLAG_INIT;
+
+static void buildPieces() {
+  for (int type = 0; type < TETROMINO_COUNT; type++) {
+    for (int rotation = 0; rotation < 4; rotation++) {
+      PieceRows_t piece = {{0}, 4, -1, 4, -1};
+      for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+          if (!getTetrominoBlock(type, rotation, x, y)) continue;
+          piece.rows[y] |= (uint8_t)(1u << x);
+          if (x < piece.min_x) piece.min_x = (int8_t)x;
+          if (x > piece.max_x) piece.max_x = (int8_t)x;
+          if (y < piece.min_y) piece.min_y = (int8_t)y;
+          if (y > piece.max_y) piece.max_y = (int8_t)y;
+        }
+      }
+      pieces[type][rotation] = piece;
+    }
+  }
+}
+
+// Общие тела ядер принимают размер слова константой: в обертках ниже
+// ветвления по нему исчезают, и каждое ядро работает со своим словом
+static inline uint64_t loadRow(int bits, int y) {
+  switch (bits) {
+    case 16:
+      return game.rows.rows16[y];
+    case 32:
+      return game.rows.rows32[y];
+    default:
+      return game.rows.rows64[y];
+  }
+}
+
+static inline void storeRow(int bits, int y, uint64_t row) {
+  switch (bits) {
+    case 16:
+      game.rows.rows16[y] = (uint16_t)row;
+      break;
+    case 32:
+      game.rows.rows32[y] = (uint32_t)row;
+      break;
+    default:
+      game.rows.rows64[y] = row;
+  }
+}
+
+static inline uint64_t fullRow(int width) {
+  return width == 64 ? ~0ull : (1ull << width) - 1;
+}
+
+// Строка фигуры, сдвинутая к столбцу x поля (x бывает отрицательным)
+static inline uint64_t shiftRow(uint8_t row, int x) {
+  return x >= 0 ? (uint64_t)row << x : (uint64_t)row >> -x;
+}
+
+static inline bool collidesRows(int bits, Tetromino_t tetromino) {
+  const PieceRows_t *piece = &pieces[tetromino.type][tetromino.rotation];
+  if (tetromino.x + piece->min_x < 0 ||
+      tetromino.x + piece->max_x >= game.info.width ||
+      tetromino.y + piece->max_y >= game.info.height) {
+    return true;
+  }
+  // Блоки выше поля ни с чем не пересекаются
+  for (int i = piece->min_y; i <= piece->max_y; i++) {
+    int y = tetromino.y + i;
+    if (y >= 0 && loadRow(bits, y) & shiftRow(piece->rows[i], tetromino.x)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline void placeRows(int bits, Tetromino_t tetromino) {
+  const PieceRows_t *piece = &pieces[tetromino.type][tetromino.rotation];
+  Cell_t cell = CELL_PIECE(tetromino.type);
+  for (int i = piece->min_y; i <= piece->max_y; i++) {
+    int y = tetromino.y + i;
+    if (y < 0 || y >= game.info.height) continue;
+    uint64_t mask =
+        shiftRow(piece->rows[i], tetromino.x) & fullRow(game.info.width);
+    storeRow(bits, y, loadRow(bits, y) | mask);
+    for (; mask; mask &= mask - 1) {
+      game.cells[y][__builtin_ctzll(mask)] = cell;
+    }
+  }
+}
+
+static inline int clearRows(int bits, uint8_t *cleared) {
+  uint64_t full = fullRow(game.info.width);
+  int count = 0;
+  // Неполные строки сдвигаются вниз за один проход снизу вверх
+  for (int src = game.info.height - 1, dst = src; src >= 0; src--) {
+    uint64_t row = loadRow(bits, src);
+    if (row == full) {
+      if (count < 4) cleared[count] = (uint8_t)src;
+      count++;
+      continue;
+    }
+    if (dst != src) {
+      storeRow(bits, dst, row);
+      memcpy(game.cells[dst], game.cells[src], (size_t)game.info.width);
+    }
+    dst--;
+  }
+  for (int y = 0; y < count; y++) {
+    storeRow(bits, y, 0);
+    memset(game.cells[y], CELL_EMPTY, (size_t)game.info.width);
+  }
+  return count;
+}
+
+static inline void syncRow(int bits, int y) {
+  uint64_t row = 0;
+  for (int x = 0; x < game.info.width; x++) {
+    if (game.cells[y][x] != CELL_EMPTY) row |= 1ull << x;
+  }
+  storeRow(bits, y, row);
+}
+
+#define BOARD_KERNELS(bits)                                              \
+  static bool collides##bits(Tetromino_t t) { return collidesRows(bits, t); } \
+  static void place##bits(Tetromino_t t) { placeRows(bits, t); }          \
+  static int clear##bits(uint8_t *rows) { return clearRows(bits, rows); } \
+  static void sync##bits(int y) { syncRow(bits, y); }                     \
+  static const BoardKernels_t kernels##bits = {                          \
+      collides##bits, place##bits, clear##bits, sync##bits, bits};
+
+BOARD_KERNELS(16)
+BOARD_KERNELS(32)
+BOARD_KERNELS(64)
+
+const BoardKernels_t *boardKernels(int width) {
+  call_once(&pieces_once, buildPieces);
+  return width <= 16 ? &kernels16 : width <= 32 ? &kernels32 : &kernels64;
+}
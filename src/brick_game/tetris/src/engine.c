@@ -0,0 +1,304 @@
+#include <stdalign.h>
+
+#include "tetris.h"
+
+_Static_assert(alignof(GameSnapshot_t) <= alignof(max_align_t),
+               "snapshot buffers are max_align_t aligned");
+
+// Цвета в порядке типов: I, O, T, S, Z, J, L и мусорные линии
+static const EngineColors_t palette[TETROMINO_COUNT + 1] = {
+    {ENGINE_CYAN, ENGINE_BLACK},    {ENGINE_YELLOW, ENGINE_BLACK},
+    {ENGINE_MAGENTA, ENGINE_BLACK}, {ENGINE_GREEN, ENGINE_BLACK},
+    {ENGINE_RED, ENGINE_BLACK},     {ENGINE_BLUE, ENGINE_BLACK},
+    {ENGINE_WHITE, ENGINE_BLACK},   {ENGINE_BLACK, ENGINE_WHITE}};
+
+static const EngineInfo_t info = {"TETRIS", TETROMINO_COUNT + 1, palette};
+
+#define ENCODE_VERSION 2  // Версия формата engineEncode, 4 бита
+#define ENCODE_OFFSET 8   // Смещение координат фигуры: x в 7 битах, y в 6
+
+/**
+ * @brief Поток битов упакованной игры: младшие биты байта идут первыми
+ */
+typedef struct {
+  uint8_t *out;        // Буфер записи или NULL при чтении
+  const uint8_t *in;   // Данные чтения
+  size_t size;         // Размер буфера или данных
+  size_t length;       // Записано или прочитано байт
+  uint64_t bits;       // Накопленные биты
+  int count;           // Их число
+  bool overflow;       // Буфер мал или данные кончились
+} BitStream_t;
+
+static void putBits(BitStream_t *stream, uint32_t value, int count) {
+  stream->bits |= (uint64_t)(value & (uint32_t)((1ull << count) - 1))
+                  << stream->count;
+  stream->count += count;
+  while (stream->count >= 8) {
+    if (stream->length < stream->size) {
+      stream->out[stream->length] = (uint8_t)stream->bits;
+    } else {
+      stream->overflow = true;
+    }
+    stream->length++;
+    stream->bits >>= 8;
+    stream->count -= 8;
+  }
+}
+
+// Строка поля шириной до 64 бит пишется двумя половинами
+static void putRow(BitStream_t *stream, uint64_t row, int width) {
+  if (width > 32) {
+    putBits(stream, (uint32_t)row, 32);
+    putBits(stream, (uint32_t)(row >> 32), width - 32);
+  } else {
+    putBits(stream, (uint32_t)row, width);
+  }
+}
+
+static uint32_t getBits(BitStream_t *stream, int count) {
+  while (stream->count < count) {
+    if (stream->length < stream->size) {
+      stream->bits |= (uint64_t)stream->in[stream->length] << stream->count;
+    } else {
+      stream->overflow = true;
+    }
+    stream->length++;
+    stream->count += 8;
+  }
+  uint32_t value = (uint32_t)(stream->bits & ((1ull << count) - 1));
+  stream->bits >>= count;
+  stream->count -= count;
+  return value;
+}
+
+static uint64_t getRow(BitStream_t *stream, int width) {
+  if (width <= 32) return getBits(stream, width);
+  uint64_t low = getBits(stream, 32);
+  return low | (uint64_t)getBits(stream, width - 32) << 32;
+}
+
+const EngineInfo_t *engineInfo(void) { return &info; }
+
+void engineInit(void) { initGame(); }
+
+void engineNewGame(uint32_t seed) {
+  seedGame(seed);
+  resetGame();
+  game.time_ms = game.last_time = 0;
+}
+
+void engineSuspend(void) {
+  game.state = GAME_EXIT;
+  game.held = HELD_NONE;
+}
+
+void engineRecordResults(bool record) {
+  setLeaderboardFile(record ? LEADERBOARD_FILE : NULL);
+  loadHighScore();
+}
+
+bool engineResize(int width, int height) {
+  return setFieldSize(width, height);
+}
+
+void engineAutoRepeat(int delay_ms, int interval_ms) {
+  setAutoRepeat(delay_ms, interval_ms);
+}
+
+void engineFree(void) { freeGame(); }
+
+EngineState_t engineState(void) {
+  switch (game.state) {
+    case GAME_START:
+      return ENGINE_START;
+    case GAME_PAUSE:
+      return ENGINE_PAUSED;
+    case GAME_OVER:
+      return ENGINE_OVER;
+    case GAME_EXIT:
+      return ENGINE_EXIT;
+    default:
+      return ENGINE_PLAYING;
+  }
+}
+
+int engineActiveCells(EngineCell_t *cells) {
+  if (game.state != GAME_MOVING) return 0;
+  int count = 0;
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      int fx = game.current.x + x, fy = game.current.y + y;
+      if (getTetrominoBlock(game.current.type, game.current.rotation, x, y) &&
+          fx >= 0 && fx < game.info.width && fy >= 0 &&
+          fy < game.info.height) {
+        cells[count++] = (EngineCell_t){(int8_t)fx, (int8_t)fy,
+                                        CELL_PIECE(game.current.type)};
+      }
+    }
+  }
+  return count;
+}
+
+GameInfo_t engineStep(int ms) { return stepGame(ms); }
+
+uint64_t engineVersion(void) { return game.version; }
+
+int64_t engineTimeout(void) {
+  if (game.state != GAME_MOVING) return -1;
+  // Фигура сдвигается, когда прошло больше info.speed мс
+  int64_t elapsed =
+      game.frozen ? game.frozen_ms : game.time_ms - game.last_time;
+  int64_t due = game.info.speed + 1 - elapsed;
+  // Удерживаемый сдвиг повторяется в repeat_at
+  if (game.held != HELD_NONE && game.repeat_at - game.time_ms < due) {
+    due = game.repeat_at - game.time_ms;
+  }
+  return due > 0 ? due : 0;
+}
+
+size_t engineSnapshotSize(void) { return sizeof(GameSnapshot_t); }
+
+void engineSave(void *snapshot) { saveSnapshot(snapshot); }
+
+void engineLoad(const void *snapshot) { loadSnapshot(snapshot); }
+
+// Раскладка: версия, состояние, размер поля, строки поля по биту на
+// клетку, виды занятых клеток по 3 бита, фигура, очередь, счет, генератор
+// и время с последнего шага гравитации; пустое поле 10×20 занимает 25 байт
+size_t engineEncode(uint8_t *out, size_t size) {
+  BitStream_t stream = {.out = out, .size = size};
+  putBits(&stream, ENCODE_VERSION, 4);
+  putBits(&stream, (uint32_t)game.state, 3);
+  const int width = game.info.width, height = game.info.height;
+  putBits(&stream, (uint32_t)width - 1, 6);
+  putBits(&stream, (uint32_t)height - 1, 5);
+  for (int y = 0; y < height; y++) {
+    uint64_t row = 0;
+    for (int x = 0; x < width; x++) {
+      if (game.cells[y][x] != CELL_EMPTY) row |= 1ull << x;
+    }
+    putRow(&stream, row, width);
+  }
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      if (game.cells[y][x] != CELL_EMPTY) {
+        putBits(&stream, game.cells[y][x] - 1u, 3);
+      }
+    }
+  }
+  putBits(&stream, (uint32_t)game.current.type, 3);
+  putBits(&stream, (uint32_t)game.current.rotation, 2);
+  putBits(&stream, (uint32_t)(game.current.x + ENCODE_OFFSET), 7);
+  putBits(&stream, (uint32_t)(game.current.y + ENCODE_OFFSET), 6);
+  // Очередь пишется от ближайшей фигуры, поэтому голова всегда нулевая
+  putBits(&stream, (uint32_t)game.queue_length, 3);
+  for (int i = 0; i < game.queue_length; i++) {
+    putBits(&stream, (uint32_t)peekNextPiece(i), 3);
+  }
+  putBits(&stream, (uint32_t)game.info.score, 32);
+  putBits(&stream, (uint32_t)game.info.high_score, 32);
+  putBits(&stream, (uint32_t)game.info.level, 4);
+  putBits(&stream, (uint32_t)game.info.speed, 16);
+  putBits(&stream, (uint32_t)game.lines_cleared, 32);
+  putBits(&stream, (uint32_t)game.garbage_out, 16);
+  putBits(&stream, game.rng_state, 32);
+  // Гравитация зависит только от времени с последнего шага
+  int64_t elapsed =
+      game.frozen ? game.frozen_ms : game.time_ms - game.last_time;
+  putBits(&stream, (uint32_t)(elapsed < 0 ? 0 : elapsed > 0xFFFF ? 0xFFFF
+                                                                  : elapsed),
+          16);
+  if (stream.count > 0) putBits(&stream, 0, 8 - stream.count);
+  return stream.overflow ? 0 : stream.length;
+}
+
+bool engineDecode(const uint8_t *data, size_t size) {
+  BitStream_t stream = {.in = data, .size = size};
+  if (getBits(&stream, 4) != ENCODE_VERSION) return false;
+  static _Thread_local Game_t decoded;
+  decoded = game;
+  decoded.state = (GameState_t)getBits(&stream, 3);
+  const int width = (int)getBits(&stream, 6) + 1;
+  const int height = (int)getBits(&stream, 5) + 1;
+  if (width < FIELD_SIZE_MIN || height < FIELD_SIZE_MIN) return false;
+  memset(decoded.cells, CELL_EMPTY, sizeof(decoded.cells));
+  memset(&decoded.rows, 0, sizeof(decoded.rows));
+  for (int y = 0; y < height; y++) {
+    uint64_t row = getRow(&stream, width);
+    for (int x = 0; x < width; x++) {
+      decoded.cells[y][x] = (Cell_t)(row >> x & 1);
+    }
+  }
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      if (decoded.cells[y][x] != CELL_EMPTY) {
+        decoded.cells[y][x] = (Cell_t)(getBits(&stream, 3) + 1);
+      }
+    }
+  }
+  decoded.current.type = (int)getBits(&stream, 3);
+  decoded.current.rotation = (int)getBits(&stream, 2);
+  decoded.current.x = (int)getBits(&stream, 7) - ENCODE_OFFSET;
+  decoded.current.y = (int)getBits(&stream, 6) - ENCODE_OFFSET;
+  decoded.queue_head = 0;
+  decoded.queue_length = (int)getBits(&stream, 3);
+  bool valid = decoded.queue_length >= 1 &&
+               decoded.queue_length <= NEXT_QUEUE_MAX &&
+               decoded.current.type < TETROMINO_COUNT &&
+               decoded.state <= GAME_EXIT;
+  for (int i = 0; valid && i < decoded.queue_length; i++) {
+    decoded.queue[i] = (int)getBits(&stream, 3);
+    valid = decoded.queue[i] < TETROMINO_COUNT;
+  }
+  if (!valid) return false;
+  decoded.info.score = (int)getBits(&stream, 32);
+  decoded.info.high_score = (int)getBits(&stream, 32);
+  decoded.info.level = (int)getBits(&stream, 4);
+  decoded.info.speed = (int)getBits(&stream, 16);
+  decoded.lines_cleared = (int)getBits(&stream, 32);
+  decoded.garbage_out = (int)getBits(&stream, 16);
+  decoded.rng_state = getBits(&stream, 32);
+  // Часы потока могут быть любыми: отсчет гравитации продолжится с первого
+  // шага времени после распаковки, а у паузы — после ее снятия
+  decoded.frozen_ms = getBits(&stream, 16);
+  decoded.last_time = decoded.time_ms - decoded.frozen_ms;
+  decoded.frozen = decoded.state == GAME_MOVING ||
+                   decoded.state == GAME_SHIFTING ||
+                   decoded.state == GAME_PAUSE;
+  decoded.info.pause = decoded.state == GAME_PAUSE;
+  // Удержание клавиши не сохраняется
+  decoded.held = HELD_NONE;
+  // Остаток последнего байта — нули выравнивания
+  if (stream.overflow || stream.length != size || stream.bits != 0 ||
+      decoded.rng_state == 0) {
+    return false;
+  }
+
+  // Фигура проверяется на уже распакованном поле
+  decoded.info.width = width;
+  decoded.info.height = height;
+  decoded.kernels = boardKernels(width);
+  static _Thread_local Game_t previous;
+  previous = game;
+  game = decoded;
+  for (int y = 0; y < height; y++) game.kernels->sync(y);
+  game.info.field = game.cells;
+  game.info.next = getPreview(game.queue[0]);
+  game.version = previous.version + 1;
+  bool active = game.state == GAME_MOVING || game.state == GAME_SHIFTING ||
+                game.state == GAME_PAUSE;
+  if (active && !canMove(game.current, 0, 0)) {
+    game = previous;
+    return false;
+  }
+  return true;
+}
+
+int engineStatus(char *buffer, size_t size) {
+  return snprintf(buffer, size,
+                  "state %d score %d level %d lines %d piece %d %d %d",
+                  game.state, game.info.score, game.info.level,
+                  game.lines_cleared, game.current.type, game.current.x,
+                  game.current.y);
+}
@@ -0,0 +1,311 @@
+#include "eval.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define EVAL_X86
+#include <immintrin.h>
+#endif
+
+// Каждая строка с виртуальными стенами (FIELD_WIDTH + 2 бита) должна
+// помещаться в 16-битную ячейку вектора
+_Static_assert(FIELD_WIDTH + 2 <= 16, "row with walls must fit 16 bits");
+
+#define WALLED_MASK ((uint16_t)((1u << (FIELD_WIDTH + 1)) - 1))
+#define LEFT_WALL ((uint16_t)1u)
+#define RIGHT_WALL ((uint16_t)(1u << (FIELD_WIDTH - 1)))
+
+Bitboard_t boardFromField(Cell_t (*field)[FIELD_WIDTH_MAX]) {
+  Bitboard_t board = {{0}};
+  for (int y = 0; y < FIELD_HEIGHT; y++) {
+    for (int x = 0; x < FIELD_WIDTH; x++) {
+      if (field[y][x]) board.rows[y] |= (uint16_t)(1u << x);
+    }
+  }
+  return board;
+}
+
+static int popcount16(uint16_t v) {
+  v = (uint16_t)(v - ((v >> 1) & 0x5555));
+  v = (uint16_t)((v & 0x3333) + ((v >> 2) & 0x3333));
+  v = (uint16_t)((v + (v >> 4)) & 0x0f0f);
+  return (v + (v >> 8)) & 0x1f;
+}
+
+static void evaluateBoard(const Bitboard_t *board, BoardFeatures_t *out) {
+  int aggregate = 0, holes = 0, bumpiness = 0, empty_rows = 0;
+  int row_transitions = 0, column_transitions = 0, wells = 0, complete = 0;
+  uint16_t seen = 0, prev = 0;
+
+  for (int y = 0; y < FIELD_HEIGHT; y++) {
+    uint16_t row = board->rows[y] & BITBOARD_FULL_ROW;
+    seen |= row;
+    aggregate += popcount16(seen);
+    empty_rows += seen == 0;
+    holes += popcount16((uint16_t)~row & seen & BITBOARD_FULL_ROW);
+    bumpiness += popcount16((seen ^ (seen >> 1)) & (BITBOARD_FULL_ROW >> 1));
+
+    uint16_t walled = (uint16_t)((row << 1) | 1u | (1u << (FIELD_WIDTH + 1)));
+    row_transitions += popcount16((walled ^ (walled >> 1)) & WALLED_MASK);
+    column_transitions += popcount16(row ^ prev);
+    prev = row;
+
+    uint16_t left = (uint16_t)((row << 1) | LEFT_WALL);
+    uint16_t right = (uint16_t)((row >> 1) | RIGHT_WALL);
+    wells += popcount16((uint16_t)~seen & left & right & BITBOARD_FULL_ROW);
+    complete += row == BITBOARD_FULL_ROW;
+  }
+  column_transitions += popcount16((uint16_t)~prev & BITBOARD_FULL_ROW);
+
+  out->values[FEATURE_AGGREGATE_HEIGHT] = (int16_t)aggregate;
+  out->values[FEATURE_COMPLETE_LINES] = (int16_t)complete;
+  out->values[FEATURE_HOLES] = (int16_t)holes;
+  out->values[FEATURE_BUMPINESS] = (int16_t)bumpiness;
+  out->values[FEATURE_MAX_HEIGHT] = (int16_t)(FIELD_HEIGHT - empty_rows);
+  out->values[FEATURE_ROW_TRANSITIONS] = (int16_t)row_transitions;
+  out->values[FEATURE_COLUMN_TRANSITIONS] = (int16_t)column_transitions;
+  out->values[FEATURE_WELL_CELLS] = (int16_t)wells;
+}
+
+void evaluateBoardsScalar(const Bitboard_t *boards, int count,
+                          BoardFeatures_t *out) {
+  for (int i = 0; i < count; i++) {
+    evaluateBoard(&boards[i], &out[i]);
+  }
+}
+
+#ifdef EVAL_X86
+// Транспонирует матрицу 8×8 из 16-битных элементов: r[i][j] -> r[j][i]
+static inline void transpose8x8(__m128i *r) {
+  __m128i t0 = _mm_unpacklo_epi16(r[0], r[1]);
+  __m128i t1 = _mm_unpackhi_epi16(r[0], r[1]);
+  __m128i t2 = _mm_unpacklo_epi16(r[2], r[3]);
+  __m128i t3 = _mm_unpackhi_epi16(r[2], r[3]);
+  __m128i t4 = _mm_unpacklo_epi16(r[4], r[5]);
+  __m128i t5 = _mm_unpackhi_epi16(r[4], r[5]);
+  __m128i t6 = _mm_unpacklo_epi16(r[6], r[7]);
+  __m128i t7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+  __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+  __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+  __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+  __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+  __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+  __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+  __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+  __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+  r[0] = _mm_unpacklo_epi64(u0, u4);
+  r[1] = _mm_unpackhi_epi64(u0, u4);
+  r[2] = _mm_unpacklo_epi64(u1, u5);
+  r[3] = _mm_unpackhi_epi64(u1, u5);
+  r[4] = _mm_unpacklo_epi64(u2, u6);
+  r[5] = _mm_unpackhi_epi64(u2, u6);
+  r[6] = _mm_unpacklo_epi64(u3, u7);
+  r[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+// Загружает 8 позиций так, что rows[y] содержит строку y каждой позиции
+static inline void loadRows8(const Bitboard_t *boards, __m128i *rows) {
+  for (int block = 0; block < BITBOARD_ROWS; block += 8) {
+    for (int i = 0; i < 8; i++) {
+      rows[block + i] =
+          _mm_load_si128((const __m128i *)&boards[i].rows[block]);
+    }
+    transpose8x8(&rows[block]);
+  }
+}
+
+// Число единичных битов в каждом байте 16-битных ячеек. Суммы по 20 строкам
+// не превышают 160 и помещаются в байт, поэтому сворачиваем байты в конце.
+static inline __m128i popcountBytes128(__m128i x) {
+  const __m128i m1 = _mm_set1_epi16(0x5555);
+  const __m128i m2 = _mm_set1_epi16(0x3333);
+  const __m128i m4 = _mm_set1_epi16(0x0f0f);
+  x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+  x = _mm_add_epi16(_mm_and_si128(x, m2),
+                    _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+  return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)), m4);
+}
+
+static inline __m128i foldBytes128(__m128i x) {
+  return _mm_add_epi16(_mm_and_si128(x, _mm_set1_epi16(0xff)),
+                       _mm_srli_epi16(x, 8));
+}
+
+// Признаки 8 позиций: по одной позиции в каждой 16-битной ячейке
+static void evaluate8(const Bitboard_t *boards, BoardFeatures_t *out) {
+  __m128i rows[BITBOARD_ROWS];
+  loadRows8(boards, rows);
+
+  const __m128i full = _mm_set1_epi16((short)BITBOARD_FULL_ROW);
+  const __m128i bump_mask = _mm_set1_epi16((short)(BITBOARD_FULL_ROW >> 1));
+  const __m128i walls =
+      _mm_set1_epi16((short)(1u | (1u << (FIELD_WIDTH + 1))));
+  const __m128i walled_mask = _mm_set1_epi16((short)WALLED_MASK);
+  const __m128i left_wall = _mm_set1_epi16((short)LEFT_WALL);
+  const __m128i right_wall = _mm_set1_epi16((short)RIGHT_WALL);
+  const __m128i zero = _mm_setzero_si128();
+
+  __m128i seen = zero, prev = zero;
+  __m128i aggregate = zero, holes = zero, bumpiness = zero, empty_rows = zero;
+  __m128i row_tr = zero, col_tr = zero, wells = zero, complete = zero;
+
+  for (int y = 0; y < FIELD_HEIGHT; y++) {
+    __m128i row = _mm_and_si128(rows[y], full);
+    seen = _mm_or_si128(seen, row);
+    aggregate = _mm_add_epi16(aggregate, popcountBytes128(seen));
+    empty_rows = _mm_sub_epi16(empty_rows, _mm_cmpeq_epi16(seen, zero));
+    holes = _mm_add_epi16(
+        holes, popcountBytes128(_mm_andnot_si128(row, seen)));
+    __m128i steps = _mm_xor_si128(seen, _mm_srli_epi16(seen, 1));
+    bumpiness = _mm_add_epi16(
+        bumpiness, popcountBytes128(_mm_and_si128(steps, bump_mask)));
+
+    __m128i walled = _mm_or_si128(_mm_slli_epi16(row, 1), walls);
+    __m128i changes = _mm_xor_si128(walled, _mm_srli_epi16(walled, 1));
+    row_tr = _mm_add_epi16(
+        row_tr, popcountBytes128(_mm_and_si128(changes, walled_mask)));
+    col_tr =
+        _mm_add_epi16(col_tr, popcountBytes128(_mm_xor_si128(row, prev)));
+    prev = row;
+
+    __m128i left = _mm_or_si128(_mm_slli_epi16(row, 1), left_wall);
+    __m128i right = _mm_or_si128(_mm_srli_epi16(row, 1), right_wall);
+    __m128i open = _mm_andnot_si128(seen, full);
+    wells = _mm_add_epi16(
+        wells,
+        popcountBytes128(_mm_and_si128(open, _mm_and_si128(left, right))));
+    complete = _mm_sub_epi16(complete, _mm_cmpeq_epi16(row, full));
+  }
+  col_tr =
+      _mm_add_epi16(col_tr, popcountBytes128(_mm_andnot_si128(prev, full)));
+
+  __m128i features[FEATURE_COUNT];
+  features[FEATURE_AGGREGATE_HEIGHT] = foldBytes128(aggregate);
+  features[FEATURE_COMPLETE_LINES] = complete;
+  features[FEATURE_HOLES] = foldBytes128(holes);
+  features[FEATURE_BUMPINESS] = foldBytes128(bumpiness);
+  features[FEATURE_MAX_HEIGHT] =
+      _mm_sub_epi16(_mm_set1_epi16(FIELD_HEIGHT), empty_rows);
+  features[FEATURE_ROW_TRANSITIONS] = foldBytes128(row_tr);
+  features[FEATURE_COLUMN_TRANSITIONS] = foldBytes128(col_tr);
+  features[FEATURE_WELL_CELLS] = foldBytes128(wells);
+
+  // После транспонирования features[i] — вектор признаков позиции i
+  transpose8x8(features);
+  for (int i = 0; i < 8; i++) {
+    _mm_storeu_si128((__m128i *)out[i].values, features[i]);
+  }
+}
+
+__attribute__((target("avx2"))) static inline __m256i popcountBytes256(
+    __m256i x) {
+  const __m256i m1 = _mm256_set1_epi16(0x5555);
+  const __m256i m2 = _mm256_set1_epi16(0x3333);
+  const __m256i m4 = _mm256_set1_epi16(0x0f0f);
+  x = _mm256_sub_epi16(x, _mm256_and_si256(_mm256_srli_epi16(x, 1), m1));
+  x = _mm256_add_epi16(_mm256_and_si256(x, m2),
+                       _mm256_and_si256(_mm256_srli_epi16(x, 2), m2));
+  return _mm256_and_si256(_mm256_add_epi16(x, _mm256_srli_epi16(x, 4)), m4);
+}
+
+__attribute__((target("avx2"))) static inline __m256i foldBytes256(__m256i x) {
+  return _mm256_add_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0xff)),
+                          _mm256_srli_epi16(x, 8));
+}
+
+// Признаки 16 позиций: позиции 0–7 в младшей половине вектора, 8–15 в старшей
+__attribute__((target("avx2"))) static void evaluate16(
+    const Bitboard_t *boards, BoardFeatures_t *out) {
+  __m128i lo[BITBOARD_ROWS], hi[BITBOARD_ROWS];
+  loadRows8(boards, lo);
+  loadRows8(boards + 8, hi);
+
+  const __m256i full = _mm256_set1_epi16((short)BITBOARD_FULL_ROW);
+  const __m256i bump_mask = _mm256_set1_epi16((short)(BITBOARD_FULL_ROW >> 1));
+  const __m256i walls =
+      _mm256_set1_epi16((short)(1u | (1u << (FIELD_WIDTH + 1))));
+  const __m256i walled_mask = _mm256_set1_epi16((short)WALLED_MASK);
+  const __m256i left_wall = _mm256_set1_epi16((short)LEFT_WALL);
+  const __m256i right_wall = _mm256_set1_epi16((short)RIGHT_WALL);
+  const __m256i zero = _mm256_setzero_si256();
+
+  __m256i seen = zero, prev = zero;
+  __m256i aggregate = zero, holes = zero, bumpiness = zero, empty_rows = zero;
+  __m256i row_tr = zero, col_tr = zero, wells = zero, complete = zero;
+
+  for (int y = 0; y < FIELD_HEIGHT; y++) {
+    __m256i row = _mm256_inserti128_si256(_mm256_castsi128_si256(lo[y]),
+                                          hi[y], 1);
+    row = _mm256_and_si256(row, full);
+    seen = _mm256_or_si256(seen, row);
+    aggregate = _mm256_add_epi16(aggregate, popcountBytes256(seen));
+    empty_rows = _mm256_sub_epi16(empty_rows, _mm256_cmpeq_epi16(seen, zero));
+    holes = _mm256_add_epi16(
+        holes, popcountBytes256(_mm256_andnot_si256(row, seen)));
+    __m256i steps = _mm256_xor_si256(seen, _mm256_srli_epi16(seen, 1));
+    bumpiness = _mm256_add_epi16(
+        bumpiness, popcountBytes256(_mm256_and_si256(steps, bump_mask)));
+
+    __m256i walled = _mm256_or_si256(_mm256_slli_epi16(row, 1), walls);
+    __m256i changes = _mm256_xor_si256(walled, _mm256_srli_epi16(walled, 1));
+    row_tr = _mm256_add_epi16(
+        row_tr, popcountBytes256(_mm256_and_si256(changes, walled_mask)));
+    col_tr = _mm256_add_epi16(col_tr,
+                              popcountBytes256(_mm256_xor_si256(row, prev)));
+    prev = row;
+
+    __m256i left = _mm256_or_si256(_mm256_slli_epi16(row, 1), left_wall);
+    __m256i right = _mm256_or_si256(_mm256_srli_epi16(row, 1), right_wall);
+    __m256i open = _mm256_andnot_si256(seen, full);
+    wells = _mm256_add_epi16(
+        wells, popcountBytes256(
+                   _mm256_and_si256(open, _mm256_and_si256(left, right))));
+    complete = _mm256_sub_epi16(complete, _mm256_cmpeq_epi16(row, full));
+  }
+  col_tr = _mm256_add_epi16(
+      col_tr, popcountBytes256(_mm256_andnot_si256(prev, full)));
+
+  __m256i features[FEATURE_COUNT];
+  features[FEATURE_AGGREGATE_HEIGHT] = foldBytes256(aggregate);
+  features[FEATURE_COMPLETE_LINES] = complete;
+  features[FEATURE_HOLES] = foldBytes256(holes);
+  features[FEATURE_BUMPINESS] = foldBytes256(bumpiness);
+  features[FEATURE_MAX_HEIGHT] =
+      _mm256_sub_epi16(_mm256_set1_epi16(FIELD_HEIGHT), empty_rows);
+  features[FEATURE_ROW_TRANSITIONS] = foldBytes256(row_tr);
+  features[FEATURE_COLUMN_TRANSITIONS] = foldBytes256(col_tr);
+  features[FEATURE_WELL_CELLS] = foldBytes256(wells);
+
+  __m128i low[FEATURE_COUNT], high[FEATURE_COUNT];
+  for (int f = 0; f < FEATURE_COUNT; f++) {
+    low[f] = _mm256_castsi256_si128(features[f]);
+    high[f] = _mm256_extracti128_si256(features[f], 1);
+  }
+  transpose8x8(low);
+  transpose8x8(high);
+  for (int i = 0; i < 8; i++) {
+    _mm_storeu_si128((__m128i *)out[i].values, low[i]);
+    _mm_storeu_si128((__m128i *)out[i + 8].values, high[i]);
+  }
+}
+
+static bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+#endif
+
+// Векторные ядра рассчитаны на ровно 8 признаков (одна матрица 8×8)
+_Static_assert(FEATURE_COUNT == 8, "SIMD kernels transpose 8 features");
+
+void evaluateBoards(const Bitboard_t *boards, int count, BoardFeatures_t *out) {
+  int done = 0;
+#ifdef EVAL_X86
+  if (cpuHasAvx2()) {
+    for (; done + 16 <= count; done += 16) {
+      evaluate16(boards + done, out + done);
+    }
+  }
+  for (; done + 8 <= count; done += 8) {
+    evaluate8(boards + done, out + done);
+  }
+#endif
+  evaluateBoardsScalar(boards + done, count - done, out + done);
+}
@@ -0,0 +1,145 @@
+#define _DEFAULT_SOURCE
+
+#include "leaderboard.h"
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Открывает и отображает файл таблицы под блокировкой flock.
+// При writable файл создается и инициализируется, если он пуст.
+static LeaderboardFile_t *mapLeaderboard(const char *path, bool writable,
+                                         int *fd_out) {
+  int fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+  if (fd < 0) return NULL;
+
+  LeaderboardFile_t *board = NULL;
+  struct stat st;
+  if (flock(fd, writable ? LOCK_EX : LOCK_SH) == 0 && fstat(fd, &st) == 0) {
+    bool fresh = writable && st.st_size == 0;
+    bool sized = st.st_size == (off_t)sizeof(LeaderboardFile_t);
+    if (fresh) {
+      sized = ftruncate(fd, (off_t)sizeof(LeaderboardFile_t)) == 0;
+    }
+    if (sized) {
+      void *p = mmap(NULL, sizeof(LeaderboardFile_t),
+                     writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                     fd, 0);
+      if (p != MAP_FAILED) board = p;
+    }
+    if (board && fresh) {
+      board->magic = LEADERBOARD_MAGIC;
+      board->version = LEADERBOARD_VERSION;
+      board->capacity = LEADERBOARD_CAPACITY;
+      board->count = 0;
+    }
+    if (board && (board->magic != LEADERBOARD_MAGIC ||
+                  board->version != LEADERBOARD_VERSION ||
+                  board->capacity != LEADERBOARD_CAPACITY ||
+                  board->count > LEADERBOARD_CAPACITY)) {
+      munmap(board, sizeof(LeaderboardFile_t));
+      board = NULL;
+    }
+  }
+
+  if (!board) {
+    close(fd);  // Закрытие дескриптора снимает блокировку
+    return NULL;
+  }
+  *fd_out = fd;
+  return board;
+}
+
+static void unmapLeaderboard(LeaderboardFile_t *board, int fd) {
+  munmap(board, sizeof(LeaderboardFile_t));
+  flock(fd, LOCK_UN);
+  close(fd);
+}
+
+// Первая позиция, где счет строго меньше score (двоичный поиск)
+static uint32_t findInsertPos(const LeaderboardFile_t *board, int32_t score) {
+  uint32_t lo = 0, hi = board->count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (board->entries[mid].score >= score) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static void removeEntry(LeaderboardFile_t *board, uint32_t index) {
+  memmove(&board->entries[index], &board->entries[index + 1],
+          (board->count - index - 1) * sizeof(LeaderboardEntry_t));
+  board->count--;
+}
+
+int leaderboardInsert(const char *path, const LeaderboardEntry_t *entry) {
+  int fd;
+  LeaderboardFile_t *board = mapLeaderboard(path, true, &fd);
+  if (!board) return -1;
+
+  LeaderboardEntry_t record = *entry;
+  record.player[LEADERBOARD_NAME_SIZE - 1] = '\0';
+  uint32_t pos = findInsertPos(board, record.score);
+
+  // Ищем худший результат игрока и число его записей
+  int player_count = 0;
+  uint32_t worst = 0;
+  for (uint32_t i = 0; i < board->count; i++) {
+    if (strncmp(board->entries[i].player, record.player,
+                LEADERBOARD_NAME_SIZE) == 0) {
+      player_count++;
+      worst = i;
+    }
+  }
+
+  int result = -1;
+  bool accepted = true;
+  if (player_count >= LEADERBOARD_PER_PLAYER) {
+    if (worst < pos) {
+      accepted = false;  // Не лучше худшего результата игрока
+    } else {
+      removeEntry(board, worst);
+    }
+  }
+  if (accepted && board->count == LEADERBOARD_CAPACITY) {
+    if (pos >= LEADERBOARD_CAPACITY) {
+      accepted = false;
+    } else {
+      board->count--;  // Вытесняем последний результат таблицы
+    }
+  }
+  if (accepted) {
+    memmove(&board->entries[pos + 1], &board->entries[pos],
+            (board->count - pos) * sizeof(LeaderboardEntry_t));
+    board->entries[pos] = record;
+    board->count++;
+    result = (int)pos;
+  }
+
+  unmapLeaderboard(board, fd);
+  return result;
+}
+
+int leaderboardRead(const char *path, LeaderboardEntry_t *out, int max) {
+  int fd;
+  LeaderboardFile_t *board = mapLeaderboard(path, false, &fd);
+  if (!board) return 0;
+
+  int n = (int)board->count < max ? (int)board->count : max;
+  memcpy(out, board->entries, (size_t)(n > 0 ? n : 0) * sizeof(*out));
+  unmapLeaderboard(board, fd);
+  return n;
+}
+
+int leaderboardBest(const char *path) {
+  LeaderboardEntry_t top;
+  return leaderboardRead(path, &top, 1) == 1 ? top.score : 0;
+}
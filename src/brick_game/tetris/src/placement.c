@@ -0,0 +1,157 @@
+#include "placement.h"
+
+#include <string.h>
+
+#include "arena.h"
+
+// Положения поиска: x от -3, y от -4 (фигура, поднятая мусором)
+#define SEARCH_LEFT 3
+#define SEARCH_TOP 4
+
+static bool collides(Tetromino_t piece) {
+  return game.kernels->collides(piece);
+}
+
+// Номер положения в таблицах поиска
+static inline int stateIndex(Tetromino_t t, int rows, int columns) {
+  return ((t.rotation * rows) + t.y + SEARCH_TOP) * columns + t.x +
+         SEARCH_LEFT;
+}
+
+// Фиксирует фигуру там, куда она упадет, и выпускает следующую
+static void lockPiece(Tetromino_t piece, PlaceResult_t *result) {
+  piece.y++;
+  while (!collides(piece)) piece.y++;
+  piece.y--;
+
+  int score = game.info.score;
+  uint8_t rows[4];
+  game.current = piece;
+  placeTetromino(piece);
+  int lines = clearFullLines(rows);
+  if (result) {
+    result->piece = piece;
+    result->score = game.info.score - score;
+    result->lines = lines;
+    memcpy(result->rows, rows, sizeof(rows));
+  }
+  spawnTetromino();
+  game.last_time = game.time_ms;
+  game.version++;
+}
+
+// Путь без обходов: повороты на месте, затем сдвиг по горизонтали
+static bool directRoute(int rotation, int x, Tetromino_t *piece) {
+  Tetromino_t t = game.current;
+  while (t.rotation != rotation) {
+    t.rotation = (t.rotation + 1) % 4;
+    if (collides(t)) return false;
+  }
+  int dx = x > t.x ? 1 : -1;
+  while (t.x != x) {
+    t.x += dx;
+    if (collides(t)) return false;
+  }
+  *piece = t;
+  return true;
+}
+
+// Поиск в ширину по всем положениям, достижимым из текущего; находит
+// самое верхнее положение с заданными поворотом и столбцом
+static bool searchRoute(int rotation, int x, Tetromino_t *piece) {
+  const int columns = game.info.width + SEARCH_LEFT;
+  const int rows = game.info.height + SEARCH_TOP;
+  const int states = 4 * rows * columns;
+  Tetromino_t start = game.current;
+  if (start.x + SEARCH_LEFT < 0 || start.x >= game.info.width ||
+      start.y + SEARCH_TOP < 0 || start.y >= game.info.height) {
+    return false;
+  }
+
+  Arena_t *arena = threadArena();
+  if (!arena) return false;
+  size_t mark = arenaMark(arena);
+  uint8_t *seen = arenaAlloc(arena, (size_t)states);
+  int *queue = arenaAlloc(arena, sizeof(int) * (size_t)states);
+  if (!seen || !queue) {
+    arenaRelease(arena, mark);
+    return false;
+  }
+  memset(seen, 0, (size_t)states);
+
+  int head = 0, tail = 0;
+  seen[stateIndex(start, rows, columns)] = 1;
+  queue[tail++] = stateIndex(start, rows, columns);
+  while (head < tail) {
+    int state = queue[head++];
+    Tetromino_t t = {state % columns - SEARCH_LEFT,
+                     state / columns % rows - SEARCH_TOP, start.type,
+                     state / columns / rows};
+    const Tetromino_t next[4] = {{t.x - 1, t.y, t.type, t.rotation},
+                                 {t.x + 1, t.y, t.type, t.rotation},
+                                 {t.x, t.y + 1, t.type, t.rotation},
+                                 {t.x, t.y, t.type, (t.rotation + 1) % 4}};
+    for (int i = 0; i < 4; i++) {
+      // Положение без столкновения не выходит за границы поиска
+      if (collides(next[i])) continue;
+      int index = stateIndex(next[i], rows, columns);
+      if (seen[index]) continue;
+      seen[index] = 1;
+      queue[tail++] = index;
+    }
+  }
+
+  bool found = false;
+  Tetromino_t target = {x, 0, start.type, rotation};
+  if (x + SEARCH_LEFT >= 0 && x < game.info.width) {
+    for (int y = -SEARCH_TOP; y < game.info.height && !found; y++) {
+      target.y = y;
+      found = seen[stateIndex(target, rows, columns)];
+    }
+  }
+  arenaRelease(arena, mark);
+  if (found) *piece = target;
+  return found;
+}
+
+bool placePiece(int rotation, int x, PlaceResult_t *result) {
+  if (game.state != GAME_MOVING || rotation < 0 || rotation > 3) return false;
+  Tetromino_t piece;
+  if (!directRoute(rotation, x, &piece) && !searchRoute(rotation, x, &piece)) {
+    return false;
+  }
+  lockPiece(piece, result);
+  return true;
+}
+
+bool placePath(const UserAction_t *path, int count, PlaceResult_t *result) {
+  if (game.state != GAME_MOVING) return false;
+  Tetromino_t piece = game.current;
+  for (int i = 0; i < count; i++) {
+    switch (path[i]) {
+      case Left:
+        piece.x--;
+        break;
+      case Right:
+        piece.x++;
+        break;
+      case Down:
+        piece.y++;
+        break;
+      case Action:
+        piece.rotation = (piece.rotation + 1) % 4;
+        break;
+      default:
+        return false;
+    }
+    if (collides(piece)) return false;
+  }
+  lockPiece(piece, result);
+  return true;
+}
+
+void dropPiece(void) {
+  userInput(Down, false);
+  // Следующая фигура появляется на шаге
+  stepGame(0);
+}
@@ -0,0 +1,133 @@
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "spectator.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+               "Feed atomics must be lock-free to work across processes");
+_Static_assert(FIELD_WIDTH <= 16, "Feed rows are packed into uint16_t");
+
+static SpectatorFeed_t *feed = NULL;
+static char feed_name[64];
+static SpectatorFrame_t last_frame;
+
+bool spectatorOpen(const char *name) {
+  if (feed || strlen(name) >= sizeof(feed_name)) return false;
+
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if (fd < 0) return false;
+
+  bool ok = ftruncate(fd, sizeof(SpectatorFeed_t)) == 0;
+  void *map = ok ? mmap(NULL, sizeof(SpectatorFeed_t), PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0)
+                 : MAP_FAILED;
+  close(fd);
+  if (map == MAP_FAILED) {
+    shm_unlink(name);
+    return false;
+  }
+
+  feed = map;
+  memset(feed, 0, sizeof(SpectatorFeed_t));
+  feed->magic = SPECTATOR_MAGIC;
+  feed->version = SPECTATOR_VERSION;
+  strcpy(feed_name, name);
+  return true;
+}
+
+static void packFrame(SpectatorFrame_t *frame) {
+  memset(frame, 0, sizeof(SpectatorFrame_t));
+  // Поле по умолчанию ведут ядра с 16-битными строками
+  memcpy(frame->rows, game.rows.rows16, sizeof(frame->rows));
+  frame->piece = (int8_t)game.current.type;
+  frame->rotation = (int8_t)game.current.rotation;
+  frame->x = (int8_t)game.current.x;
+  frame->y = (int8_t)game.current.y;
+  frame->next = (int8_t)peekNextPiece(0);
+  frame->state = (uint8_t)game.state;
+  frame->level = (uint8_t)game.info.level;
+  frame->pause = (uint8_t)game.info.pause;
+  frame->score = game.info.score;
+  frame->high_score = game.info.high_score;
+}
+
+bool spectatorPublish() {
+  if (!feed || !game.info.field) return true;
+  // Формат трансляции рассчитан на поле размера по умолчанию
+  if (game.info.width != FIELD_WIDTH || game.info.height != FIELD_HEIGHT) {
+    return false;
+  }
+
+  // Неизменившийся кадр не публикуем; номер сравнивается нулевым
+  SpectatorFrame_t frame;
+  packFrame(&frame);
+  uint64_t head = atomic_load_explicit(&feed->head, memory_order_relaxed);
+  if (head && memcmp(&frame, &last_frame, sizeof(frame)) == 0) return true;
+  last_frame = frame;
+
+  frame.number = head + 1;
+  SpectatorSlot_t *slot = &feed->slots[frame.number % SPECTATOR_RING_SIZE];
+  unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+  atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  slot->frame = frame;
+  atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+  atomic_store_explicit(&feed->head, frame.number, memory_order_release);
+  return true;
+}
+
+void spectatorClose() {
+  if (feed) {
+    munmap(feed, sizeof(SpectatorFeed_t));
+    shm_unlink(feed_name);
+    feed = NULL;
+    memset(&last_frame, 0, sizeof(last_frame));
+  }
+}
+
+const SpectatorFeed_t *spectatorAttach(const char *name) {
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) return NULL;
+
+  struct stat st;
+  void *map = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(SpectatorFeed_t)) {
+    map = mmap(NULL, sizeof(SpectatorFeed_t), PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (map == MAP_FAILED) return NULL;
+
+  const SpectatorFeed_t *attached = map;
+  if (attached->magic != SPECTATOR_MAGIC ||
+      attached->version != SPECTATOR_VERSION) {
+    munmap(map, sizeof(SpectatorFeed_t));
+    return NULL;
+  }
+  return attached;
+}
+
+bool spectatorRead(const SpectatorFeed_t *feed_map, SpectatorFrame_t *frame) {
+  for (int attempt = 0; attempt < SPECTATOR_READ_RETRIES; attempt++) {
+    uint64_t head = atomic_load_explicit(
+        (atomic_uint_least64_t *)&feed_map->head, memory_order_acquire);
+    if (head == 0) return false;
+
+    const SpectatorSlot_t *slot = &feed_map->slots[head % SPECTATOR_RING_SIZE];
+    atomic_uint *seq = (atomic_uint *)&slot->seq;
+    unsigned before = atomic_load_explicit(seq, memory_order_acquire);
+    if (before & 1u) continue;  // Слот переписывается
+    memcpy(frame, &slot->frame, sizeof(SpectatorFrame_t));
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(seq, memory_order_relaxed) == before) return true;
+  }
+  return false;
+}
+
+void spectatorDetach(const SpectatorFeed_t *feed_map) {
+  if (feed_map) munmap((void *)feed_map, sizeof(SpectatorFeed_t));
+}
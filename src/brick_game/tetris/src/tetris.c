@@ -1,6 +1,50 @@
 #include "tetris.h"
 
-Game_t game = {0};
+#include <threads.h>
+
+#include "trace.h"
+
+_Thread_local Game_t game = {0};
+
+static const char *leaderboard_file = LEADERBOARD_FILE;
+
+#ifdef TETRIS_EVENTS
+_Thread_local GameEventRing_t game_events = {0};
+
+// Добавляет событие в кольцевой буфер; при переполнении событие теряется
+static void emitEvent(uint8_t type, Tetromino_t t, uint8_t count,
+                      const uint8_t *rows) {
+  if (game_events.head - game_events.tail >= EVENT_RING_SIZE) {
+    game_events.dropped++;
+    return;
+  }
+  GameEvent_t *e =
+      &game_events.events[game_events.head & (EVENT_RING_SIZE - 1)];
+  e->type = type;
+  e->piece = (uint8_t)t.type;
+  e->rotation = (uint8_t)t.rotation;
+  e->count = count;
+  e->x = (int8_t)t.x;
+  e->y = (int8_t)t.y;
+  for (int i = 0; i < 4; i++) e->rows[i] = rows && i < count ? rows[i] : 0;
+  e->reserved[0] = e->reserved[1] = 0;
+  e->score = game.info.score;
+  game_events.head++;
+}
+
+int pollGameEvents(GameEvent_t *out, int max) {
+  int n = 0;
+  while (n < max && game_events.tail != game_events.head) {
+    out[n++] = game_events.events[game_events.tail & (EVENT_RING_SIZE - 1)];
+    game_events.tail++;
+  }
+  return n;
+}
+
+#define EMIT_EVENT(type, t, count, rows) emitEvent(type, t, count, rows)
+#else
+#define EMIT_EVENT(type, t, count, rows) ((void)0)
+#endif
 
 // Тетромино данные (7 типов × 4 поворота × 4×4 матрица)
 static const int tetromino_shapes[7][4][4][4] = {
@@ -46,18 +90,96 @@ static const int tetromino_shapes[7][4][4][4] = {
      {{0, 0, 0, 0}, {0, 0, 0, 0}, {1, 1, 1, 0}, {1, 0, 0, 0}},
      {{0, 0, 0, 0}, {1, 1, 0, 0}, {0, 1, 0, 0}, {0, 1, 0, 0}}}};
 
+// Превью фигур в начальном повороте, заполняются однократно при первом
+// initGame в любом потоке; info.next указывает на строки нужной фигуры
+static int preview_bitmaps[TETROMINO_COUNT][NEXT_SIZE][NEXT_SIZE];
+
+#define PREVIEW_ROWS(t)                                 \
+  {preview_bitmaps[t][0], preview_bitmaps[t][1],        \
+   preview_bitmaps[t][2], preview_bitmaps[t][3]}
+static int *preview_rows[TETROMINO_COUNT][NEXT_SIZE] = {
+    PREVIEW_ROWS(0), PREVIEW_ROWS(1), PREVIEW_ROWS(2), PREVIEW_ROWS(3),
+    PREVIEW_ROWS(4), PREVIEW_ROWS(5), PREVIEW_ROWS(6)};
+
+// Генератор xorshift32: состояние хранится в game, поэтому последовательность
+// фигур воспроизводима по зерну
+static int randomPiece() {
+  uint32_t x = game.rng_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  game.rng_state = x;
+  return (int)(x % TETROMINO_COUNT);
+}
+
+void seedGame(uint32_t seed) {
+  // Нулевое состояние xorshift вырождено
+  game.rng_state = seed ? seed : 0x9E3779B9u;
+}
+
+static once_flag preview_once = ONCE_FLAG_INIT;
+
+static void buildPreviews() {
+  for (int type = 0; type < TETROMINO_COUNT; type++) {
+    for (int y = 0; y < NEXT_SIZE; y++) {
+      for (int x = 0; x < NEXT_SIZE; x++) {
+        preview_bitmaps[type][y][x] = getTetrominoBlock(type, 0, x, y);
+      }
+    }
+  }
+}
+
+// Задает размер поля и выбирает ядра под него
+static void applyFieldSize(int width, int height) {
+  game.info.width = width;
+  game.info.height = height;
+  game.kernels = boardKernels(width);
+}
+
 void initGame() {
-  // Инициализация игрового поля
-  game.info.field = malloc(FIELD_HEIGHT * sizeof(int *));
-  for (int i = 0; i < FIELD_HEIGHT; i++) {
-    game.info.field[i] = calloc(FIELD_WIDTH, sizeof(int));
+  // Поле хранится в самой структуре игры, наружу отдается только указатель
+  game.info.field = game.cells;
+  if (!game.kernels) applyFieldSize(FIELD_WIDTH, FIELD_HEIGHT);
+  call_once(&preview_once, buildPreviews);
+  if (game.queue_length < 1 || game.queue_length > NEXT_QUEUE_MAX) {
+    game.queue_length = NEXT_QUEUE_DEFAULT;
   }
+  if (game.repeat_delay < 1 || game.repeat_interval < 1) {
+    setAutoRepeat(ENGINE_REPEAT_DELAY_MS, ENGINE_REPEAT_INTERVAL_MS);
+  }
+
+  loadHighScore();
+  seedGame((uint32_t)time(NULL));
 
-  // Инициализация поля для следующей фигуры
-  game.info.next = malloc(NEXT_SIZE * sizeof(int *));
-  for (int i = 0; i < NEXT_SIZE; i++) {
-    game.info.next[i] = calloc(NEXT_SIZE, sizeof(int));
+  resetGame();
+}
+
+bool setFieldSize(int width, int height) {
+  if (width < FIELD_SIZE_MIN || width > FIELD_WIDTH_MAX ||
+      height < FIELD_SIZE_MIN || height > FIELD_HEIGHT_MAX) {
+    return false;
   }
+  applyFieldSize(width, height);
+  resetGame();
+  return true;
+}
+
+void setAutoRepeat(int delay_ms, int interval_ms) {
+  game.repeat_delay = delay_ms > 1 ? delay_ms : 1;
+  game.repeat_interval = interval_ms > 1 ? interval_ms : 1;
+}
+
+void setCell(int x, int y, Cell_t cell) {
+  if (x < 0 || x >= game.info.width || y < 0 || y >= game.info.height) return;
+  game.cells[y][x] = cell;
+  game.kernels->sync(y);
+}
+
+void resetGame() {
+  if (!game.kernels) applyFieldSize(FIELD_WIDTH, FIELD_HEIGHT);
+  // Очищаем поле на месте, без выделения памяти
+  memset(game.cells, CELL_EMPTY, sizeof(game.cells));
+  memset(&game.rows, 0, sizeof(game.rows));
 
   game.state = GAME_START;
   game.info.score = 0;
@@ -65,36 +187,50 @@ void initGame() {
   game.info.speed = 150;
   game.info.pause = 0;
   game.lines_cleared = 0;
-
-  loadHighScore();
-  srand(time(NULL));
-
-  game.next.type = rand() % TETROMINO_COUNT;
-  game.next.rotation = 0;
-
-  // Обновляем матрицу next для отображения
-  for (int y = 0; y < NEXT_SIZE; y++) {
-    for (int x = 0; x < NEXT_SIZE; x++) {
-      game.info.next[y][x] =
-          getTetrominoBlock(game.next.type, game.next.rotation, x, y);
-    }
+  game.garbage_out = 0;
+  game.held = HELD_NONE;
+  game.frozen = false;
+
+  // Заполняем очередь следующих фигур заранее
+  game.queue_head = 0;
+  for (int i = 0; i < game.queue_length; i++) {
+    game.queue[i] = randomPiece();
   }
+  game.info.next = preview_rows[game.queue[0]];
 }
 
 void freeGame() {
-  if (game.info.field) {
-    for (int i = 0; i < FIELD_HEIGHT; i++) {
-      free(game.info.field[i]);
-    }
-    free(game.info.field);
-  }
+  game.info.field = NULL;
+  game.info.next = NULL;
+}
 
-  if (game.info.next) {
-    for (int i = 0; i < NEXT_SIZE; i++) {
-      free(game.info.next[i]);
-    }
-    free(game.info.next);
+void setNextQueueLength(int length) {
+  if (length < 1) length = 1;
+  if (length > NEXT_QUEUE_MAX) length = NEXT_QUEUE_MAX;
+
+  // Разворачиваем кольцо в линейный порядок и дополняем новыми фигурами
+  int pieces[NEXT_QUEUE_MAX];
+  int known = game.queue_length >= 1 && game.queue_length <= NEXT_QUEUE_MAX
+                  ? game.queue_length
+                  : 0;
+  for (int i = 0; i < length; i++) {
+    pieces[i] = i < known ? game.queue[(game.queue_head + i) % known]
+                          : randomPiece();
   }
+  memcpy(game.queue, pieces, length * sizeof(int));
+  game.queue_head = 0;
+  game.queue_length = length;
+  game.info.next = preview_rows[game.queue[0]];
+}
+
+int peekNextPiece(int index) {
+  if (index < 0 || index >= game.queue_length) return -1;
+  return game.queue[(game.queue_head + index) % game.queue_length];
+}
+
+int **getPreview(int type) {
+  if (type < 0 || type >= TETROMINO_COUNT) return NULL;
+  return preview_rows[type];
 }
 
 int getTetrominoBlock(int type, int rotation, int x, int y) {
@@ -105,90 +241,54 @@ int getTetrominoBlock(int type, int rotation, int x, int y) {
   return tetromino_shapes[type][rotation][y][x];
 }
 
+// Фигура неизвестного типа или поворота не имеет блоков
+static bool validTetromino(Tetromino_t tetromino) {
+  return tetromino.type >= 0 && tetromino.type < TETROMINO_COUNT &&
+         tetromino.rotation >= 0 && tetromino.rotation < 4;
+}
+
 bool canMove(Tetromino_t tetromino, int dx, int dy) {
-  // Проверяем каждую ячейку в 4x4 матрице тетромино
-  for (int y = 0; y < 4; y++) {
-    for (int x = 0; x < 4; x++) {
-      if (getTetrominoBlock(tetromino.type, tetromino.rotation, x, y)) {
-        // Вычисляем новые координаты блока после смещения
-        int newX = tetromino.x + x + dx;
-        int newY = tetromino.y + y + dy;
-        // Проверяем, выходит ли блок за границы поля или пересекает другие
-        // блоки
-        if (newX < 0 || newX >= FIELD_WIDTH || newY >= FIELD_HEIGHT ||
-            (newY >= 0 && game.info.field[newY][newX])) {
-          return false;
-        }
-      }
-    }
-  }
-  return true;
+  if (!validTetromino(tetromino)) return true;
+  // Блоки проверяются по битам строк ядром под ширину поля
+  tetromino.x += dx;
+  tetromino.y += dy;
+  return !game.kernels->collides(tetromino);
 }
 
 bool canRotate(Tetromino_t tetromino) {
-  int newRotation = (tetromino.rotation + 1) % 4;
-  for (int y = 0; y < 4; y++) {
-    for (int x = 0; x < 4; x++) {
-      if (getTetrominoBlock(tetromino.type, newRotation, x, y)) {
-        int newX = tetromino.x + x;
-        int newY = tetromino.y + y;
-
-        if (newX < 0 || newX >= FIELD_WIDTH || newY >= FIELD_HEIGHT ||
-            (newY >= 0 && game.info.field[newY][newX])) {
-          return false;
-        }
-      }
-    }
-  }
-  return true;
+  if (!validTetromino(tetromino)) return true;
+  tetromino.rotation = (tetromino.rotation + 1) % 4;
+  return !game.kernels->collides(tetromino);
 }
 
 void placeTetromino(Tetromino_t tetromino) {
-  for (int y = 0; y < 4; y++) {
-    for (int x = 0; x < 4; x++) {
-      if (getTetrominoBlock(tetromino.type, tetromino.rotation, x, y)) {
-        int fieldX = tetromino.x + x;
-        int fieldY = tetromino.y + y;
-        if (fieldY >= 0) {
-          game.info.field[fieldY][fieldX] = 1;
-        }
-      }
-    }
-  }
+  if (validTetromino(tetromino)) game.kernels->place(tetromino);
+  EMIT_EVENT(EVENT_PLACE, tetromino, 0, NULL);
 }
 
 void clearLines() {
-  int linesCleared = 0;
-
-  for (int y = FIELD_HEIGHT - 1; y >= 0; y--) {
-    bool fullLine = true;
-    for (int x = 0; x < FIELD_WIDTH; x++) {
-      if (!game.info.field[y][x]) {
-        fullLine = false;
-        break;
-      }
-    }
+  uint8_t rows[4];
+  clearFullLines(rows);
+}
 
-    if (fullLine) {
-      // Сдвигаем все линии вниз
-      for (int moveY = y; moveY > 0; moveY--) {
-        for (int x = 0; x < FIELD_WIDTH; x++) {
-          game.info.field[moveY][x] = game.info.field[moveY - 1][x];
-        }
-      }
-      // Очищаем верхнюю линию
-      for (int x = 0; x < FIELD_WIDTH; x++) {
-        game.info.field[0][x] = 0;
-      }
-      linesCleared++;
-      y++;  // Проверяем эту же линию снова
-    }
-  }
+int clearFullLines(uint8_t *rows) {
+  TRACE_BEGIN("clearLines");
+  // Исходные индексы очищенных строк (до сдвига поля)
+  memset(rows, 0, 4);
+  int linesCleared = game.kernels->clear(rows);
 
   if (linesCleared > 0) {
+    int prevLevel = game.info.level;
     updateScore(linesCleared);
+    EMIT_EVENT(EVENT_LINE_CLEAR, game.current, (uint8_t)linesCleared, rows);
+    if (game.info.level > prevLevel) {
+      EMIT_EVENT(EVENT_LEVEL_UP, game.current, (uint8_t)game.info.level, NULL);
+    }
     game.lines_cleared += linesCleared;
+    game.garbage_out += garbageForLines(linesCleared);
   }
+  TRACE_END("clearLines");
+  return linesCleared;
 }
 
 void updateScore(int lines) {
@@ -197,7 +297,6 @@ void updateScore(int lines) {
     game.info.score += scores[lines];
     if (game.info.score > game.info.high_score) {
       game.info.high_score = game.info.score;
-      saveHighScore();
     }
 
     // Увеличение уровня каждые 600 очков
@@ -214,33 +313,34 @@ void updateScore(int lines) {
 }
 
 void spawnTetromino() {
-  game.current = game.next;
-  game.current.x = FIELD_WIDTH / 2 - 2;
+  TRACE_BEGIN("spawnTetromino");
+  game.current.type = game.queue[game.queue_head];
+  game.current.rotation = 0;
+  game.current.x = game.info.width / 2 - 2;
   game.current.y = 0;
 
-  // Генерируем следующую фигуру
-  game.next.type = rand() % TETROMINO_COUNT;
-  game.next.rotation = 0;
-
-  // Обновляем матрицу next
-  for (int y = 0; y < NEXT_SIZE; y++) {
-    for (int x = 0; x < NEXT_SIZE; x++) {
-      game.info.next[y][x] =
-          getTetrominoBlock(game.next.type, game.next.rotation, x, y);
-    }
-  }
+  // Освободившийся слот очереди становится последним: дописываем в него
+  // новую фигуру и сдвигаем голову
+  game.queue[game.queue_head] = randomPiece();
+  game.queue_head = (game.queue_head + 1) % game.queue_length;
+  game.info.next = preview_rows[game.queue[game.queue_head]];
 
   // Проверяем окончена ли игра
   if (!canMove(game.current, 0, 0)) {
     game.state = GAME_OVER;
+    recordGameResult();
+    EMIT_EVENT(EVENT_GAME_OVER, game.current, 0, NULL);
   } else {
     game.state = GAME_MOVING;
+    EMIT_EVENT(EVENT_SPAWN, game.current, 0, NULL);
   }
+  TRACE_END("spawnTetromino");
 }
 
 void rotateTetromino() {
   if (canRotate(game.current)) {
     game.current.rotation = (game.current.rotation + 1) % 4;
+    EMIT_EVENT(EVENT_ROTATE, game.current, 0, NULL);
   }
 }
 
@@ -248,6 +348,7 @@ void moveTetromino(int dx, int dy) {
   if (canMove(game.current, dx, dy)) {
     game.current.x += dx;
     game.current.y += dy;
+    EMIT_EVENT(EVENT_MOVE, game.current, 0, NULL);
   }
 }
 
@@ -260,39 +361,65 @@ void dropTetromino() {
   game.state = GAME_SPAWN;
 }
 
-void saveHighScore() {
-  FILE *file = fopen(HIGH_SCORE_FILE, "w");
-  if (file) {
-    fprintf(file, "%d", game.info.high_score);
-    fclose(file);
-  }
+// Заполняет запись таблицы рекордов данными текущей игры
+static LeaderboardEntry_t makeEntry(int score) {
+  LeaderboardEntry_t entry = {0};
+  const char *player = getenv("USER");
+  strncpy(entry.player, player && *player ? player : "player",
+          LEADERBOARD_NAME_SIZE - 1);
+  entry.score = score;
+  entry.level = game.info.level;
+  entry.lines = game.lines_cleared;
+  entry.timestamp = (int64_t)time(NULL);
+  return entry;
 }
 
 void loadHighScore() {
-  FILE *file = fopen(HIGH_SCORE_FILE, "r");
-  if (file) {
-    fscanf(file, "%d", &game.info.high_score);
-    fclose(file);
-  } else {
-    game.info.high_score = 0;
+  game.info.high_score =
+      leaderboard_file ? leaderboardBest(leaderboard_file) : 0;
+}
+
+void recordGameResult() {
+  if (leaderboard_file && game.info.score > 0) {
+    TRACE_BEGIN("recordGameResult");
+    LeaderboardEntry_t entry = makeEntry(game.info.score);
+    leaderboardInsert(leaderboard_file, &entry);
+    TRACE_END("recordGameResult");
   }
 }
 
+void setLeaderboardFile(const char *path) { leaderboard_file = path; }
+
+// Начинает удержание: первый повтор сдвига — через задержку, мягкого
+// падения — через интервал
+static void startRepeat(UserAction_t action) {
+  game.held = action;
+  game.repeat_at = game.time_ms + (action == Down ? game.repeat_interval
+                                                  : game.repeat_delay);
+}
+
 void userInput(UserAction_t action, bool hold) {
-  (void)hold;  // Пока не используем
+  // Отпускание удерживаемого сдвига и повторное нажатие без отпускания
+  // (повтор клавиатуры) ничего не делают
+  bool shift = action == Left || action == Right || action == Down;
+  if (shift && game.held == (int)action) {
+    if (!hold) game.held = HELD_NONE;
+    return;
+  }
 
   if (game.state == GAME_SHIFTING && action != Pause && action != Terminate) {
     return;
   }
+  TRACE_BEGIN("userInput");
 
   switch (action) {
     case Start:
       if (game.state == GAME_START) {
         spawnTetromino();
         game.state = GAME_MOVING;
-        game.last_time = clock();
+        game.last_time = game.time_ms;
       } else if (game.state == GAME_OVER) {
-        initGame();
+        resetGame();
       } else if (game.state == GAME_PAUSE) {
         game.state = GAME_MOVING;
         game.info.pause = 0;
@@ -302,26 +429,42 @@ void userInput(UserAction_t action, bool hold) {
       if (game.state == GAME_MOVING) {
         game.state = GAME_PAUSE;
         game.info.pause = 1;
+        // Часы идут и во время паузы; гравитация — нет
+        game.frozen = true;
+        game.frozen_ms = game.time_ms - game.last_time;
+        // Отпускание может прийти уже после паузы
+        game.held = HELD_NONE;
       } else if (game.state == GAME_PAUSE) {
         game.state = GAME_MOVING;
         game.info.pause = 0;
       }
       break;
     case Terminate:
+      if (game.state != GAME_START && game.state != GAME_OVER &&
+          game.state != GAME_EXIT) {
+        recordGameResult();
+      }
       game.state = GAME_EXIT;
       break;
     case Left:
       if (game.state == GAME_MOVING) {
         moveTetromino(-1, 0);
+        if (hold) startRepeat(Left);
       }
       break;
     case Right:
       if (game.state == GAME_MOVING) {
         moveTetromino(1, 0);
+        if (hold) startRepeat(Right);
       }
       break;
     case Down:
-      if (game.state == GAME_MOVING) {
+      // Нажатие сбрасывает фигуру, удержание опускает ее построчно
+      if (game.state == GAME_MOVING && hold) {
+        if (canMove(game.current, 0, 1)) game.last_time = game.time_ms;
+        moveTetromino(0, 1);
+        startRepeat(Down);
+      } else if (game.state == GAME_MOVING) {
         dropTetromino();
       }
       break;
@@ -334,24 +477,47 @@ void userInput(UserAction_t action, bool hold) {
       // Не используется
       break;
   }
+  game.version++;
+  TRACE_END("userInput");
 }
 
-GameInfo_t updateCurrentState() {
-  clock_t current_time = clock();
+// Повторяет удерживаемый сдвиг за все интервалы, прошедшие к time_ms
+static void autoRepeat() {
+  if (game.held == HELD_NONE || game.state != GAME_MOVING) return;
+  int dx = game.held == Left ? -1 : game.held == Right ? 1 : 0;
+  int dy = game.held == Down ? 1 : 0;
+  while (game.repeat_at <= game.time_ms) {
+    if (!canMove(game.current, dx, dy)) {
+      // У стены или на блоках повтор ждет, не накапливая пропущенные шаги
+      game.repeat_at = game.time_ms + game.repeat_interval;
+      break;
+    }
+    moveTetromino(dx, dy);
+    // Мягкое падение заменяет шаг гравитации
+    if (dy) game.last_time = game.time_ms;
+    game.repeat_at += game.repeat_interval;
+    game.version++;
+  }
+}
+
+// Выполняет переходы по таймеру на момент game.time_ms
+static void advanceState() {
+  autoRepeat();
 
   // Переход из GAME_MOVING в GAME_SHIFTING по таймеру
   if (game.state == GAME_MOVING &&
-      (current_time - game.last_time) >
-          (game.info.speed * CLOCKS_PER_SEC / 1000)) {
+      game.time_ms - game.last_time > game.info.speed) {
     game.state = GAME_SHIFTING;
   }
 
   if (game.state == GAME_SHIFTING) {
+    game.version++;
     if (canMove(game.current, 0, 1)) {
       // Фигура может двигаться вниз - перемещаем её
       game.current.y++;
+      EMIT_EVENT(EVENT_MOVE, game.current, 0, NULL);
       game.state = GAME_MOVING;  // Возвращаемся в состояние ожидания ввода
-      game.last_time = current_time;  // Обновляем время только после сдвига
+      game.last_time = game.time_ms;  // Обновляем время только после сдвига
     } else {
       placeTetromino(game.current);
       clearLines();
@@ -363,5 +529,96 @@ GameInfo_t updateCurrentState() {
     spawnTetromino();
   }
 
+  // Указатель на поле обновляется, чтобы копия Game_t отдавала свое поле
+  game.info.field = game.cells;
+}
+
+// Продолжает отсчет гравитации, остановленный паузой, с момента time_ms
+static void thawGravity() {
+  if (game.frozen && game.state != GAME_PAUSE) {
+    game.last_time = game.time_ms - game.frozen_ms;
+    game.frozen = false;
+  }
+}
+
+GameInfo_t updateCurrentState() {
+  TRACE_BEGIN("updateCurrentState");
+  game.time_ms = gameClockNow();
+  thawGravity();
+  advanceState();
+  TRACE_END("updateCurrentState");
+  return game.info;
+}
+
+GameInfo_t stepGame(int ms) {
+  thawGravity();
+  game.time_ms += ms;
+  advanceState();
   return game.info;
-}
\ No newline at end of file
+}
+
+// Байт снимка: строки за высотой поля не используются и не копируются
+size_t gameSnapshotSize(int height) {
+  return offsetof(Game_t, cells) + (size_t)height * sizeof(game.cells[0]);
+}
+
+static size_t snapshotSize(const Game_t *source) {
+  return gameSnapshotSize(source->info.height);
+}
+
+void saveSnapshot(GameSnapshot_t *snapshot) {
+  memcpy(snapshot, &game, snapshotSize(&game));
+}
+
+void copySnapshot(GameSnapshot_t *to, const GameSnapshot_t *from) {
+  memcpy(to, from, snapshotSize(from));
+}
+
+void loadSnapshot(const GameSnapshot_t *snapshot) {
+  memcpy(&game, snapshot, snapshotSize(snapshot));
+  game.info.field = game.cells;
+}
+
+int garbageForLines(int lines) {
+  static const int garbage[] = {0, 0, 1, 2, 4};
+  return lines > 0 && lines <= 4 ? garbage[lines] : 0;
+}
+
+void addGarbage(int lines, int hole) {
+  if (lines <= 0 || game.state == GAME_OVER || game.state == GAME_EXIT) return;
+  const int width = game.info.width, height = game.info.height;
+  if (lines > height) lines = height;
+  game.version++;
+
+  // Занятые клетки в верхних строках вытесняются за поле
+  bool overflow = false;
+  for (int y = 0; y < lines && !overflow; y++) {
+    for (int x = 0; x < width; x++) {
+      if (game.cells[y][x] != CELL_EMPTY) overflow = true;
+    }
+  }
+
+  memmove(game.cells[0], game.cells[lines],
+          (size_t)(height - lines) * sizeof(game.cells[0]));
+  for (int y = height - lines; y < height; y++) {
+    memset(game.cells[y], CELL_GARBAGE, (size_t)width);
+    if (hole >= 0 && hole < width) game.cells[y][hole] = CELL_EMPTY;
+  }
+  for (int y = 0; y < height; y++) game.kernels->sync(y);
+
+  // Падающая фигура поднимается вместе с полем, если ей стало тесно
+  if (game.state != GAME_START) {
+    int lifted = 0;
+    while (!canMove(game.current, 0, 0) && lifted < lines) {
+      game.current.y--;
+      lifted++;
+    }
+    if (!canMove(game.current, 0, 0)) overflow = true;
+  }
+
+  if (overflow) {
+    game.state = GAME_OVER;
+    recordGameResult();
+    EMIT_EVENT(EVENT_GAME_OVER, game.current, 0, NULL);
+  }
+}
@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+  const char *name;
+  uint64_t ts_ns;
+  char phase;
+} TraceEvent_t;
+
+_Static_assert((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) == 0,
+               "Trace ring size must be a power of two");
+
+/**
+ * @brief Кольцо событий одного потока
+ *
+ * count — число событий за все время; событие i лежит в ячейке
+ * i % TRACE_BUFFER_SIZE, поэтому новые события затирают самые старые.
+ * Буферы связаны в список и живут до конца процесса, чтобы трасса
+ * завершившихся потоков тоже попала в файл.
+ */
+typedef struct TraceBuffer {
+  TraceEvent_t events[TRACE_BUFFER_SIZE];
+  atomic_size_t count;
+  int tid;
+  struct TraceBuffer *next;
+} TraceBuffer_t;
+
+static _Atomic(TraceBuffer_t *) trace_buffers = NULL;
+static atomic_int trace_next_tid = 1;
+static _Thread_local TraceBuffer_t *trace_local = NULL;
+
+static uint64_t nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static TraceBuffer_t *localBuffer() {
+  if (!trace_local) {
+    TraceBuffer_t *buffer = malloc(sizeof(TraceBuffer_t));
+    if (!buffer) return NULL;
+    atomic_init(&buffer->count, 0);
+    buffer->tid = atomic_fetch_add(&trace_next_tid, 1);
+
+    // Добавляем буфер в голову списка без блокировок
+    buffer->next = atomic_load(&trace_buffers);
+    while (!atomic_compare_exchange_weak(&trace_buffers, &buffer->next,
+                                         buffer)) {
+    }
+    trace_local = buffer;
+  }
+  return trace_local;
+}
+
+void traceRecord(const char *name, char phase) {
+  TraceBuffer_t *buffer = localBuffer();
+  if (!buffer) return;
+
+  size_t count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+  buffer->events[count & (TRACE_BUFFER_SIZE - 1)] =
+      (TraceEvent_t){name, nowNs(), phase};
+  // Публикуем событие после его записи
+  atomic_store_explicit(&buffer->count, count + 1, memory_order_release);
+}
+
+size_t traceDropped() {
+  size_t dropped = 0;
+  for (TraceBuffer_t *b = atomic_load(&trace_buffers); b; b = b->next) {
+    size_t count = atomic_load(&b->count);
+    if (count > TRACE_BUFFER_SIZE) dropped += count - TRACE_BUFFER_SIZE;
+  }
+  return dropped;
+}
+
+long traceWrite(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (!file) return -1;
+
+  long written = 0;
+  int pid = (int)getpid();
+  fprintf(file, "{\"traceEvents\":[\n");
+  for (TraceBuffer_t *b = atomic_load(&trace_buffers); b; b = b->next) {
+    fprintf(file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+            written ? ",\n" : "", pid, b->tid, b->tid);
+    written++;
+
+    size_t count = atomic_load_explicit(&b->count, memory_order_acquire);
+    size_t first = count > TRACE_BUFFER_SIZE ? count - TRACE_BUFFER_SIZE : 0;
+    int depth = 0;
+    for (size_t i = first; i < count; i++) {
+      const TraceEvent_t *e = &b->events[i & (TRACE_BUFFER_SIZE - 1)];
+      // Концы участков, начала которых затерты, пропускаем
+      if (e->phase == 'E' && depth == 0) continue;
+      depth += e->phase == 'B' ? 1 : -1;
+      // Chrome trace ожидает время в микросекундах
+      fprintf(file,
+              ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,"
+              "\"tid\":%d}",
+              e->name, e->phase, (double)e->ts_ns / 1000.0, pid, b->tid);
+      written++;
+    }
+  }
+  fprintf(file, "\n],\"displayTimeUnit\":\"ms\",");
+  fprintf(file, "\"otherData\":{\"dropped_events\":%zu}}\n", traceDropped());
+
+  if (fclose(file) != 0) return -1;
+  return written;
+}
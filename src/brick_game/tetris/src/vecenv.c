@@ -0,0 +1,207 @@
+#include "vecenv.h"
+
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+static GameSnapshot_t *gameAt(const VecEnv_t *env, int index) {
+  return (GameSnapshot_t *)(env->games + (size_t)index * env->game_size);
+}
+
+// Заполняет наблюдения игры index из глобальной game
+static void observe(const VecEnv_t *env, const VecEnvObs_t *obs, int index) {
+  const int width = env->width, height = env->height;
+  if (obs->boards) {
+    Cell_t *board = obs->boards + (size_t)index * height * width;
+    for (int y = 0; y < height; y++) {
+      memcpy(board + y * width, game.cells[y], (size_t)width);
+    }
+  }
+  if (obs->rows) {
+    uint16_t *rows = obs->rows + (size_t)index * height;
+    memcpy(rows, game.rows.rows16, (size_t)height * sizeof(uint16_t));
+  }
+  if (obs->pieces) {
+    int8_t *piece = obs->pieces + (size_t)index * VECENV_PIECE_FIELDS;
+    piece[0] = (int8_t)game.current.type;
+    piece[1] = (int8_t)game.current.rotation;
+    piece[2] = (int8_t)game.current.x;
+    piece[3] = (int8_t)game.current.y;
+    piece[4] = (int8_t)peekNextPiece(0);
+  }
+}
+
+// Шаг игр [from, to) в game текущего потока
+static void stepRange(VecEnv_t *env, int from, int to) {
+  const VecEnvObs_t *obs = env->obs;
+  for (int i = from; i < to; i++) {
+    loadSnapshot(gameAt(env, i));
+    int score = game.info.score;
+
+    int action = env->actions[i];
+    if (action >= Left && action <= Action) {
+      userInput((UserAction_t)action, false);
+    }
+    stepGame(env->step_ms);
+
+    int32_t reward = game.info.score - score;
+    bool done = game.state == GAME_OVER;
+    if (done) {
+      resetGame();
+      userInput(Start, false);
+    }
+
+    saveSnapshot(gameAt(env, i));
+    if (obs->rewards) obs->rewards[i] = reward;
+    if (obs->dones) obs->dones[i] = done;
+    observe(env, obs, i);
+  }
+}
+
+// Доля игр потока number из threads
+static void sliceOf(const VecEnv_t *env, int number, int *from, int *to) {
+  *from = (int)((int64_t)env->count * number / env->threads);
+  *to = (int)((int64_t)env->count * (number + 1) / env->threads);
+}
+
+typedef struct {
+  VecEnv_t *env;
+  int number;
+} VecEnvWorker_t;
+
+static int worker(void *arg) {
+  VecEnvWorker_t self = *(VecEnvWorker_t *)arg;
+  free(arg);
+  VecEnv_t *env = self.env;
+  uint64_t seen = 0;
+
+  mtx_lock(&env->lock);
+  for (;;) {
+    while (!env->stopping && env->generation == seen) {
+      cnd_wait(&env->start, &env->lock);
+    }
+    if (env->stopping) break;
+    seen = env->generation;
+    mtx_unlock(&env->lock);
+
+    int from, to;
+    sliceOf(env, self.number, &from, &to);
+    stepRange(env, from, to);
+
+    mtx_lock(&env->lock);
+    if (--env->pending == 0) cnd_signal(&env->done);
+  }
+  mtx_unlock(&env->lock);
+  freeGame();
+  return 0;
+}
+
+static void stopWorkers(VecEnv_t *env, int started) {
+  mtx_lock(&env->lock);
+  env->stopping = true;
+  cnd_broadcast(&env->start);
+  mtx_unlock(&env->lock);
+  for (int t = 0; t < started; t++) thrd_join(env->workers[t], NULL);
+}
+
+bool vecEnvInit(VecEnv_t *env, int count, int width, int height, int threads,
+                uint32_t seed) {
+  memset(env, 0, sizeof(VecEnv_t));
+  if (count < 1 || threads < 1 || threads > VECENV_MAX_THREADS) return false;
+  if (width < FIELD_SIZE_MIN || width > VECENV_WIDTH_MAX ||
+      height < FIELD_SIZE_MIN || height > FIELD_HEIGHT_MAX) {
+    return false;
+  }
+  if (threads > count) threads = count;
+
+  // Строки за высотой поля не хранятся
+  size_t align = alignof(Game_t);
+  env->game_size = (gameSnapshotSize(height) + align - 1) / align * align;
+  env->games = malloc((size_t)count * env->game_size);
+  if (!env->games) return false;
+  env->count = count;
+  env->width = width;
+  env->height = height;
+  env->step_ms = VECENV_STEP_MS;
+  env->threads = threads;
+
+  // Игры ботов не должны попадать в рекорды игрока, а исполнители иначе
+  // писали бы файл таблицы одновременно
+  setLeaderboardFile(NULL);
+
+  // Игры готовятся в game вызывающего потока, которая затем возвращается
+  Game_t saved = game;
+  initGame();
+  setFieldSize(width, height);
+  for (int i = 0; i < count; i++) {
+    seedGame(seed + (uint32_t)i);
+    resetGame();
+    userInput(Start, false);
+    saveSnapshot(gameAt(env, i));
+  }
+  game = saved;
+
+  if (mtx_init(&env->lock, mtx_plain) != thrd_success ||
+      cnd_init(&env->start) != thrd_success ||
+      cnd_init(&env->done) != thrd_success) {
+    free(env->games);
+    env->games = NULL;
+    return false;
+  }
+  for (int t = 1; t < threads; t++) {
+    VecEnvWorker_t *arg = malloc(sizeof(VecEnvWorker_t));
+    if (arg) *arg = (VecEnvWorker_t){env, t};
+    if (!arg ||
+        thrd_create(&env->workers[t - 1], worker, arg) != thrd_success) {
+      free(arg);
+      env->threads = t;  // Остановить только запущенные потоки
+      vecEnvFree(env);
+      return false;
+    }
+  }
+  return true;
+}
+
+void vecEnvStep(VecEnv_t *env, const int8_t *actions, const VecEnvObs_t *obs) {
+  Game_t saved = game;
+
+  mtx_lock(&env->lock);
+  env->actions = actions;
+  env->obs = obs;
+  env->pending = env->threads - 1;
+  env->generation++;
+  cnd_broadcast(&env->start);
+  mtx_unlock(&env->lock);
+
+  // Первую долю считает вызывающий поток
+  int from, to;
+  sliceOf(env, 0, &from, &to);
+  stepRange(env, from, to);
+
+  mtx_lock(&env->lock);
+  while (env->pending > 0) cnd_wait(&env->done, &env->lock);
+  mtx_unlock(&env->lock);
+
+  game = saved;
+}
+
+void vecEnvObserve(const VecEnv_t *env, const VecEnvObs_t *obs) {
+  Game_t saved = game;
+  for (int i = 0; i < env->count; i++) {
+    loadSnapshot(gameAt(env, i));
+    if (obs->rewards) obs->rewards[i] = 0;
+    if (obs->dones) obs->dones[i] = 0;
+    observe(env, obs, i);
+  }
+  game = saved;
+}
+
+void vecEnvFree(VecEnv_t *env) {
+  if (!env->games) return;
+  stopWorkers(env, env->threads - 1);
+  mtx_destroy(&env->lock);
+  cnd_destroy(&env->start);
+  cnd_destroy(&env->done);
+  free(env->games);
+  env->games = NULL;
+}
@@ -0,0 +1,249 @@
+#define _DEFAULT_SOURCE
+
+#include "versus.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define HANDSHAKE_TIMEOUT_MS 5000
+
+void versusInit(VersusSession_t *session, uint32_t local_seed,
+                uint32_t remote_seed) {
+  Game_t saved = game;
+  memset(session, 0, sizeof(VersusSession_t));
+
+  session->seeds[VERSUS_LOCAL] = local_seed;
+  session->seeds[VERSUS_REMOTE] = remote_seed;
+  for (int p = 0; p < 2; p++) {
+    memset(&game, 0, sizeof(game));
+    initGame();
+    seedGame(session->seeds[p]);
+    resetGame();
+    userInput(Start, false);
+    session->games[p] = game;
+    session->games[p].info.field = session->games[p].cells;
+  }
+  game = saved;
+}
+
+// Выполняет ввод и шаг одной игры сессии в глобальном экземпляре game
+static void simulatePlayer(Game_t *player, VersusInput_t input) {
+  loadSnapshot(player);
+  for (int action = Start; action <= Action; action++) {
+    if (input & (1u << action)) userInput((UserAction_t)action, false);
+  }
+  stepGame(VERSUS_TICK_MS);
+  saveSnapshot(player);
+  player->info.field = player->cells;
+}
+
+// Столбец без блока зависит от тика и зерна получателя: номера игроков
+// у сторон переставлены, а зерна у обеих одинаковые
+static int garbageHole(int64_t tick, uint32_t seed) {
+  uint32_t h = (uint32_t)tick * 2654435761u + seed * 40503u;
+  return (int)((h >> 16) % FIELD_WIDTH);
+}
+
+static void simulateTick(VersusSession_t *session, int64_t tick) {
+  int slot = (int)(tick & (VERSUS_HISTORY - 1));
+  copySnapshot(&session->snapshots[slot][0], &session->games[0]);
+  copySnapshot(&session->snapshots[slot][1], &session->games[1]);
+
+  for (int p = 0; p < 2; p++) {
+    simulatePlayer(&session->games[p], session->inputs[p][slot]);
+  }
+
+  // Мусор за очищенные линии уходит сопернику в том же тике
+  int sent[2] = {session->games[0].garbage_out,
+                 session->games[1].garbage_out};
+  for (int p = 0; p < 2; p++) {
+    int lines = sent[1 - p];
+    Game_t *player = &session->games[p];
+    player->garbage_out = 0;
+    if (lines > 0) {
+      loadSnapshot(player);
+      addGarbage(lines, garbageHole(tick, session->seeds[p]));
+      *player = game;
+      player->info.field = player->cells;
+    }
+  }
+}
+
+bool versusCanAdvance(const VersusSession_t *session) {
+  return session->tick - session->confirmed < VERSUS_MAX_ROLLBACK;
+}
+
+bool versusAdvance(VersusSession_t *session, VersusInput_t input) {
+  if (!versusCanAdvance(session)) return false;
+
+  Game_t saved = game;
+  int slot = (int)(session->tick & (VERSUS_HISTORY - 1));
+  session->inputs[VERSUS_LOCAL][slot] = input;
+  // Неизвестный удаленный ввод предсказывается пустым
+  if (session->tick >= session->confirmed) {
+    session->inputs[VERSUS_REMOTE][slot] = 0;
+  }
+  simulateTick(session, session->tick);
+  session->tick++;
+  game = saved;
+  return true;
+}
+
+bool versusRemoteInput(VersusSession_t *session, int64_t tick,
+                       VersusInput_t input) {
+  if (tick != session->confirmed) return false;
+
+  int slot = (int)(tick & (VERSUS_HISTORY - 1));
+  bool mispredicted =
+      tick < session->tick && session->inputs[VERSUS_REMOTE][slot] != input;
+  session->inputs[VERSUS_REMOTE][slot] = input;
+  session->confirmed++;
+
+  if (mispredicted) {
+    // Откат к состоянию перед тиком и повторная симуляция до текущего
+    Game_t saved = game;
+    copySnapshot(&session->games[0], &session->snapshots[slot][0]);
+    copySnapshot(&session->games[1], &session->snapshots[slot][1]);
+    for (int64_t t = tick; t < session->tick; t++) {
+      simulateTick(session, t);
+      session->resimulated++;
+    }
+    session->rollbacks++;
+    game = saved;
+  }
+  return true;
+}
+
+int versusWinner(const VersusSession_t *session) {
+  if (session->confirmed < session->tick) return -1;
+
+  bool local_over = session->games[VERSUS_LOCAL].state == GAME_OVER;
+  bool remote_over = session->games[VERSUS_REMOTE].state == GAME_OVER;
+  if (local_over && remote_over) return VERSUS_DRAW;
+  if (local_over) return VERSUS_REMOTE;
+  if (remote_over) return VERSUS_LOCAL;
+  return -1;
+}
+
+GameInfo_t versusView(const VersusSession_t *session, int player) {
+  loadSnapshot(&session->games[player]);
+  return game.info;
+}
+
+static bool socketAddress(const char *path, struct sockaddr_un *addr) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr->sun_path)) return false;
+  strcpy(addr->sun_path, path);
+  return true;
+}
+
+static int makeNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int versusListen(const char *path) {
+  struct sockaddr_un addr;
+  if (!socketAddress(path, &addr)) return -1;
+
+  int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0) return -1;
+  unlink(path);
+  int fd = -1;
+  if (bind(server, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+      listen(server, 1) == 0) {
+    fd = accept(server, NULL, NULL);
+  }
+  close(server);
+  unlink(path);
+  return fd < 0 ? -1 : makeNonBlocking(fd);
+}
+
+int versusConnect(const char *path) {
+  struct sockaddr_un addr;
+  if (!socketAddress(path, &addr)) return -1;
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return makeNonBlocking(fd);
+}
+
+// Передает или принимает ровно size байт, ожидая готовности сокета
+static bool transferAll(int fd, uint8_t *data, size_t size, bool sending) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = sending ? send(fd, data + done, size - done, MSG_NOSIGNAL)
+                        : recv(fd, data + done, size - done, 0);
+    if (n > 0) {
+      done += (size_t)n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+      struct pollfd pfd = {fd, sending ? POLLOUT : POLLIN, 0};
+      if (poll(&pfd, 1, HANDSHAKE_TIMEOUT_MS) <= 0) return false;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool versusHandshake(int fd, uint32_t seed, uint32_t *remote_seed) {
+  uint8_t out[4] = {(uint8_t)seed, (uint8_t)(seed >> 8), (uint8_t)(seed >> 16),
+                    (uint8_t)(seed >> 24)};
+  uint8_t in[4];
+  if (!transferAll(fd, out, sizeof(out), true) ||
+      !transferAll(fd, in, sizeof(in), false)) {
+    return false;
+  }
+  *remote_seed = (uint32_t)in[0] | (uint32_t)in[1] << 8 |
+                 (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+  return true;
+}
+
+bool versusSendInput(VersusLink_t *link, int64_t tick, VersusInput_t input) {
+  uint32_t t = (uint32_t)tick;
+  uint8_t packet[VERSUS_PACKET_SIZE] = {(uint8_t)t, (uint8_t)(t >> 8),
+                                        (uint8_t)(t >> 16),
+                                        (uint8_t)(t >> 24), input};
+  return transferAll(link->fd, packet, sizeof(packet), true);
+}
+
+int versusPollInputs(VersusLink_t *link, VersusSession_t *session) {
+  int packets = 0;
+  for (;;) {
+    ssize_t n = recv(link->fd, link->buffer + link->length,
+                     sizeof(link->buffer) - link->length, 0);
+    if (n == 0) return -1;
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      return -1;
+    }
+    link->length += (int)n;
+
+    int offset = 0;
+    for (; link->length - offset >= VERSUS_PACKET_SIZE;
+         offset += VERSUS_PACKET_SIZE) {
+      const uint8_t *p = link->buffer + offset;
+      uint32_t tick = (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+                      (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+      if (!versusRemoteInput(session, tick, p[4])) return -1;
+      packets++;
+    }
+    memmove(link->buffer, link->buffer + offset, link->length - offset);
+    link->length -= offset;
+  }
+  return packets;
+}
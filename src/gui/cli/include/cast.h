@@ -0,0 +1,43 @@
+#ifndef CAST_H
+#define CAST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cli.h"
+
+#define CAST_TERM "xterm-256color"  // Терминал, под который пишется вывод
+#define CAST_FRAME_MS 16  // Шаг времени кадра при экспорте сценария
+#define CAST_CHUNK_SIZE 4096  // Буфер копирования вывода кадра, байт
+
+/**
+ * @brief Начинает запись игры в файл asciicast v2
+ *
+ * Кадры рисуются drawGame на отдельном терминале ncurses, вывод которого
+ * уходит во временный файл; в запись попадает только то, что ncurses
+ * отправил бы на экран, то есть изменения с прошлого кадра. Память не
+ * растет с длиной записи.
+ *
+ * Зерно фигур пишется в заголовок полем "seed", чтобы сценарий можно было
+ * переиграть с тем же --seed.
+ * @param path Путь к файлу .cast
+ * @param frame_ms Шаг времени одного кадра; 0 — реальное время
+ * @param seed Зерно партии или NULL, если оно неизвестно
+ * @return true при успехе
+ */
+bool castOpen(const char *path, int frame_ms, const uint32_t *seed);
+
+/**
+ * @brief Записывает кадр, если он изменился
+ *
+ * Без открытой записи ничего не делает.
+ * @param info Информация о состоянии игры
+ */
+void castFrame(GameInfo_t info);
+
+/**
+ * @brief Завершает запись и закрывает файл
+ */
+void castClose();
+
+#endif  // CAST_H
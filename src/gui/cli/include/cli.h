@@ -4,18 +4,48 @@
 #include <ncurses.h>
 #include <unistd.h>
 
-#include "tetris.h"
+#include "brick_game.h"
 
-#define GAME_WINDOW_WIDTH 22
-#define GAME_WINDOW_HEIGHT 22
+// Окно поля: две колонки на клетку и рамка
+#define GAME_WINDOW_WIDTH(width) ((width) * 2 + 2)
+#define GAME_WINDOW_HEIGHT(height) ((height) + 2)
 #define INFO_WINDOW_WIDTH 20
 #define INFO_WINDOW_HEIGHT 22
+#define PIECE_COLOR_PAIR 4  // Пары PIECE_COLOR_PAIR + вид - 1 — цвета клеток
+// Повтор клавиатуры терминала: первый повтор через KEY_REPEAT_DELAY_MIN_MS..
+// KEY_REPEAT_DELAY_MS после нажатия, следующие — не реже KEY_REPEAT_GAP_MS
+#define KEY_REPEAT_DELAY_MIN_MS 200
+#define KEY_REPEAT_DELAY_MS 600
+#define KEY_REPEAT_GAP_MS 150
+
+/**
+ * @brief Окна интерфейса на одном терминале ncurses
+ */
+typedef struct {
+  SCREEN *screen;
+  WINDOW *game_win;
+  WINDOW *info_win;
+} Interface_t;
 
 /**
  * @brief Инициализирует интерфейс пользователя
  */
 void initInterface();
 
+/**
+ * @brief Создает цвета и окна интерфейса на дополнительном терминале
+ * @param screen Терминал, созданный newterm
+ * @return Интерфейс; текущим остается прежний
+ */
+Interface_t createInterface(SCREEN *screen);
+
+/**
+ * @brief Делает интерфейс текущим: drawGame рисует в его окна
+ * @param ui Интерфейс
+ * @return Прежний текущий интерфейс
+ */
+Interface_t useInterface(Interface_t ui);
+
 /**
  * @brief Очищает интерфейс пользователя
  */
@@ -29,10 +59,12 @@ void drawGame(GameInfo_t info);
 
 /**
  * @brief Отрисовывает игровое поле
- * @param win Окно для отрисовки
- * @param field Двумерный массив игрового поля
+ * @param win Окно для отрисовки, не меньше GAME_WINDOW_WIDTH(info.width) ×
+ * GAME_WINDOW_HEIGHT(info.height)
+ * @param info Состояние игры: клетки поля окрашиваются по виду, поверх
+ * рисуется движущийся объект движка
  */
-void drawField(WINDOW *win, int **field);
+void drawField(WINDOW *win, GameInfo_t info);
 
 /**
  * @brief Отрисовывает следующее тетромино
@@ -57,7 +89,22 @@ int getInput(UserAction_t *action);
 
 /**
  * @brief Основной игровой цикл
+ *
+ * Терминал не сообщает об отпускании клавиш, поэтому сдвиг влево и вправо
+ * передается движку как удержание с момента нажатия, и удерживаемый сдвиг
+ * повторяет движок (engineAutoRepeat), а не повтор клавиатуры. Повтор
+ * клавиатуры — нажатие той же клавиши не раньше KEY_REPEAT_DELAY_MIN_MS
+ * после начала удержания — только продлевает его; более раннее нажатие —
+ * новое нажатие. Отпускание передается, когда после нажатия повтор не
+ * начался за KEY_REPEAT_DELAY_MS + repeat_delay или повторы прервались
+ * дольше чем на KEY_REPEAT_GAP_MS. Нажатие Down сбрасывает фигуру, а его
+ * повтор клавиатуры начинает удержание — мягкое падение.
+ * Выход посреди партии сохраняет ее в session_file (см. session.h) и не
+ * записывает в рекорды (engineSuspend), выход без партии удаляет
+ * сохранение.
+ * @param session_file Путь к сохранению или NULL, чтобы не сохранять
+ * @param repeat_delay Задержка автоповтора движка, мс
  */
-void gameLoop();
+void gameLoop(const char *session_file, int repeat_delay);
 
 #endif  // CLI_H
\ No newline at end of file
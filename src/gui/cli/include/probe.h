@@ -0,0 +1,51 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PROBE_PENDING_MAX 1024  // Вводов, ждущих кадра, не больше
+
+/**
+ * @brief Включает замер задержки от ввода до вывода на терминал
+ *
+ * Каждый ввод помечается моментом поступления и версией состояния движка,
+ * которую он породил. Задержка ввода — время от поступления до возврата
+ * из отрисовки первого кадра с этой версией, то есть до записи кадра в
+ * терминал. При закрытии отчет с гистограммой пишется в файл в JSON.
+ * @param path Путь к файлу отчета
+ * @return true при успехе
+ */
+bool probeOpen(const char *path);
+
+/**
+ * @brief Возвращает текущее время для отметки поступления ввода
+ * @return Монотонное время, нс
+ */
+int64_t probeNow(void);
+
+/**
+ * @brief Отмечает обработанный ввод
+ *
+ * Без открытого замера ничего не делает.
+ * @param arrival_ns Момент поступления (probeNow)
+ * @param version Версия состояния после userInput (engineVersion)
+ */
+void probeInput(int64_t arrival_ns, uint64_t version);
+
+/**
+ * @brief Отмечает кадр, записанный в терминал
+ *
+ * Вызывается после drawGame; вводы с версией не новее кадра получают
+ * свою задержку.
+ * @param version Версия состояния, по которой нарисован кадр
+ */
+void probeFrame(uint64_t version);
+
+/**
+ * @brief Пишет отчет и выключает замер
+ * @return true, если отчет записан или замер не был открыт
+ */
+bool probeClose(void);
+
+#endif  // PROBE_H
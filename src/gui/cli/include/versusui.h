@@ -0,0 +1,20 @@
+#ifndef VERSUSUI_H
+#define VERSUSUI_H
+
+#include "cli.h"
+#include "versus.h"
+
+#define VERSUS_CATCHUP_MS 100  // Отставание, после которого такты не догоняются
+
+/**
+ * @brief Игровой цикл игры вдвоем
+ *
+ * Ввод собирается за такт VERSUS_TICK_MS, отправляется сопернику и
+ * применяется вместе с предсказанным вводом соперника. Поле соперника
+ * отрисовывается справа от информационной панели.
+ * @param session Сессия, начатая versusInit
+ * @param link Соединение с соперником
+ */
+void versusLoop(VersusSession_t *session, VersusLink_t *link);
+
+#endif  // VERSUSUI_H
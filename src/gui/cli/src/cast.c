@@ -0,0 +1,121 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "cast.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gameclock.h"
+
+static FILE *cast_file;    // Запись .cast
+static FILE *screen_file;  // Вывод терминала записи за текущий кадр
+static FILE *screen_input;
+static Interface_t cast_ui;
+static int cast_frame_ms;
+static int64_t cast_frames;
+static int64_t cast_start_ms;
+
+static void closeFiles() {
+  if (cast_file) fclose(cast_file);
+  if (screen_file) fclose(screen_file);
+  if (screen_input) fclose(screen_input);
+  cast_file = screen_file = screen_input = NULL;
+}
+
+bool castOpen(const char *path, int frame_ms, const uint32_t *seed) {
+  if (cast_file) return false;
+
+  cast_file = fopen(path, "w");
+  screen_file = tmpfile();
+  screen_input = fopen("/dev/null", "r");
+  SCREEN *target = cast_file && screen_file && screen_input
+                       ? newterm(CAST_TERM, screen_file, screen_input)
+                       : NULL;
+  if (!target) {
+    closeFiles();
+    return false;
+  }
+  // newterm делает новый терминал текущим; размеры берутся из terminfo
+  int width = COLS, height = LINES;
+  curs_set(0);
+  cast_ui = createInterface(target);
+
+  // Первый вывод, как в initInterface, попадет в первый кадр. Курсор не
+  // переносится, иначе неизменный кадр давал бы событие из одних его сдвигов
+  Interface_t previous = useInterface(cast_ui);
+  leaveok(stdscr, TRUE);
+  leaveok(cast_ui.game_win, TRUE);
+  leaveok(cast_ui.info_win, TRUE);
+  wrefresh(cast_ui.game_win);
+  wrefresh(cast_ui.info_win);
+  refresh();
+  useInterface(previous);
+
+  fprintf(cast_file,
+          "{\"version\": 2, \"width\": %d, \"height\": %d, "
+          "\"timestamp\": %lld, ",
+          width, height, (long long)time(NULL));
+  // Лишние поля заголовка проигрыватели пропускают
+  if (seed) fprintf(cast_file, "\"seed\": %u, ", (unsigned)*seed);
+  fprintf(cast_file, "\"env\": {\"TERM\": \"%s\"}}\n", CAST_TERM);
+  cast_frame_ms = frame_ms;
+  cast_frames = 0;
+  cast_start_ms = monotonicMs();
+  return true;
+}
+
+// Переносит накопленный вывод терминала в событие записи и очищает его
+static void writeEvent(double seconds) {
+  int fd = fileno(screen_file);
+  off_t size = lseek(fd, 0, SEEK_END);
+  if (size <= 0) return;
+
+  fprintf(cast_file, "[%.6f, \"o\", \"", seconds);
+  unsigned char chunk[CAST_CHUNK_SIZE];
+  for (off_t offset = 0; offset < size;) {
+    ssize_t length = pread(fd, chunk, sizeof(chunk), offset);
+    if (length <= 0) break;
+    for (ssize_t i = 0; i < length; i++) {
+      unsigned char ch = chunk[i];
+      if (ch == '"' || ch == '\\') {
+        fputc('\\', cast_file);
+        fputc(ch, cast_file);
+      } else if (ch < 0x20 || ch == 0x7f) {
+        fprintf(cast_file, "\\u%04x", ch);
+      } else {
+        fputc(ch, cast_file);
+      }
+    }
+    offset += length;
+  }
+  fputs("\"]\n", cast_file);
+
+  if (ftruncate(fd, 0) == 0) lseek(fd, 0, SEEK_SET);
+}
+
+void castFrame(GameInfo_t info) {
+  if (!cast_file) return;
+
+  Interface_t previous = useInterface(cast_ui);
+  drawGame(info);
+  useInterface(previous);
+
+  int64_t ms = cast_frame_ms ? cast_frames * cast_frame_ms
+                             : monotonicMs() - cast_start_ms;
+  cast_frames++;
+  writeEvent((double)ms / 1000.0);
+}
+
+void castClose() {
+  if (!cast_file) return;
+
+  Interface_t previous = useInterface(cast_ui);
+  delwin(cast_ui.game_win);
+  delwin(cast_ui.info_win);
+  endwin();
+  useInterface(previous);
+  delscreen(cast_ui.screen);
+  closeFiles();
+}
@@ -1,36 +1,82 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "cli.h"
 
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
+#include "cast.h"
+#include "gameclock.h"
+#include "probe.h"
+#include "session.h"
+#include "spectator.h"
+#include "trace.h"
+#include "versusui.h"
+
+static SCREEN *screen;
 static WINDOW *game_win;
 static WINDOW *info_win;
 
-void initInterface() {
-  initscr();
-  cbreak();
-  noecho();
-  keypad(stdscr, TRUE);
-  nodelay(stdscr, TRUE);
-  curs_set(0);
-
+// Создает цвета и окна на текущем терминале
+static void createWindows() {
   if (has_colors()) {
     start_color();
     init_pair(1, COLOR_WHITE, COLOR_BLACK);
     init_pair(2, COLOR_CYAN, COLOR_BLACK);
     init_pair(3, COLOR_WHITE, COLOR_RED);
+
+    // Пара PIECE_COLOR_PAIR + c - 1 — цвет клетки вида c
+    const EngineInfo_t *engine = engineInfo();
+    for (int kind = 0; kind < engine->cell_kinds; kind++) {
+      init_pair(PIECE_COLOR_PAIR + kind, engine->palette[kind].fg,
+                engine->palette[kind].bg);
+    }
   }
 
   // Создаем окна
-  game_win = newwin(GAME_WINDOW_HEIGHT, GAME_WINDOW_WIDTH, 1, 1);
-  info_win =
-      newwin(INFO_WINDOW_HEIGHT, INFO_WINDOW_WIDTH, 1, GAME_WINDOW_WIDTH + 2);
+  // Окна под поле по умолчанию; drawGame подгоняет их под игру
+  game_win = newwin(GAME_WINDOW_HEIGHT(FIELD_HEIGHT),
+                    GAME_WINDOW_WIDTH(FIELD_WIDTH), 1, 1);
+  info_win = newwin(INFO_WINDOW_HEIGHT, INFO_WINDOW_WIDTH, 1,
+                    GAME_WINDOW_WIDTH(FIELD_WIDTH) + 2);
 
   box(game_win, 0, 0);
   box(info_win, 0, 0);
 
-  mvwprintw(game_win, 0, 1, " TETRIS ");
+  mvwprintw(game_win, 0, 1, " %s ", engineInfo()->title);
   mvwprintw(info_win, 0, 1, " INFO ");
+}
+
+Interface_t useInterface(Interface_t ui) {
+  Interface_t previous = {screen, game_win, info_win};
+  set_term(ui.screen);
+  screen = ui.screen;
+  game_win = ui.game_win;
+  info_win = ui.info_win;
+  return previous;
+}
+
+Interface_t createInterface(SCREEN *target) {
+  Interface_t previous = useInterface((Interface_t){target, NULL, NULL});
+  createWindows();
+  return useInterface(previous);
+}
 
+void initInterface() {
+  SCREEN *terminal = newterm(NULL, stdout, stdin);
+  if (!terminal) {
+    fprintf(stderr, "Error opening terminal: %s.\n", getenv("TERM"));
+    exit(1);
+  }
+  cbreak();
+  noecho();
+  keypad(stdscr, TRUE);
+  nodelay(stdscr, TRUE);
+  curs_set(0);
+
+  useInterface(createInterface(terminal));
   wrefresh(game_win);
   wrefresh(info_win);
   refresh();
@@ -42,31 +88,32 @@ void cleanupInterface() {
   endwin();
 }
 
-void drawField(WINDOW *win, int **field) {
-  for (int y = 0; y < FIELD_HEIGHT; y++) {
-    for (int x = 0; x < FIELD_WIDTH; x++) {
-      mvwaddch(win, y + 1, x * 2 + 1, field[y][x] ? '[' : ' ');
-      mvwaddch(win, y + 1, x * 2 + 2, field[y][x] ? ']' : ' ');
-    }
-  }
+// Рисует клетку поля цветом ее вида
+static void drawCell(WINDOW *win, int x, int y, Cell_t cell, chtype left,
+                     chtype right) {
+  attr_t color = COLOR_PAIR(PIECE_COLOR_PAIR + cell - 1);
+  mvwaddch(win, y + 1, x * 2 + 1, left | color);
+  mvwaddch(win, y + 1, x * 2 + 2, right | color);
+}
 
-  // Отрисовка текущей фигуры
-  extern Game_t game;
-  if (game.state == GAME_MOVING) {
-    for (int y = 0; y < 4; y++) {
-      for (int x = 0; x < 4; x++) {
-        if (getTetrominoBlock(game.current.type, game.current.rotation, x, y)) {
-          int fieldX = game.current.x + x;
-          int fieldY = game.current.y + y;
-          if (fieldX >= 0 && fieldX < FIELD_WIDTH && fieldY >= 0 &&
-              fieldY < FIELD_HEIGHT) {
-            mvwaddch(win, fieldY + 1, fieldX * 2 + 1, '{');
-            mvwaddch(win, fieldY + 1, fieldX * 2 + 2, '}');
-          }
-        }
+void drawField(WINDOW *win, GameInfo_t info) {
+  for (int y = 0; y < info.height; y++) {
+    for (int x = 0; x < info.width; x++) {
+      if (info.field[y][x] != CELL_EMPTY) {
+        drawCell(win, x, y, info.field[y][x], '[', ']');
+      } else {
+        mvwaddch(win, y + 1, x * 2 + 1, ' ');
+        mvwaddch(win, y + 1, x * 2 + 2, ' ');
       }
     }
   }
+
+  // Отрисовка движущегося объекта
+  EngineCell_t active[ENGINE_ACTIVE_MAX];
+  int count = engineActiveCells(active);
+  for (int i = 0; i < count; i++) {
+    drawCell(win, active[i].x, active[i].y, active[i].cell, '{', '}');
+  }
 }
 
 void drawNext(WINDOW *win, int **next) {
@@ -99,9 +146,22 @@ void drawInfo(WINDOW *win, GameInfo_t info) {
   mvwprintw(win, 20, 2, "Q - Quit");
 }
 
-void drawGame(GameInfo_t info) {
-  extern Game_t game;
+// Подгоняет окна под размер поля; по умолчанию они уже такие
+static void fitWindows(int width, int height) {
+  if (getmaxx(game_win) == GAME_WINDOW_WIDTH(width) &&
+      getmaxy(game_win) == GAME_WINDOW_HEIGHT(height)) {
+    return;
+  }
+  wresize(game_win, GAME_WINDOW_HEIGHT(height), GAME_WINDOW_WIDTH(width));
+  mvwin(info_win, 1, GAME_WINDOW_WIDTH(width) + 2);
+  // Старые рамки остаются на экране, пока его не очистить
+  clear();
+  refresh();
+}
 
+void drawGame(GameInfo_t info) {
+  TRACE_BEGIN("drawGame");
+  fitWindows(info.width, info.height);
   // Очищаем окна
   werase(game_win);
   werase(info_win);
@@ -109,36 +169,36 @@ void drawGame(GameInfo_t info) {
   box(game_win, 0, 0);
   box(info_win, 0, 0);
 
-  mvwprintw(game_win, 0, 1, " TETRIS ");
+  const char *title = engineInfo()->title;
+  mvwprintw(game_win, 0, 1, " %s ", title);
   mvwprintw(info_win, 0, 1, " INFO ");
 
-  drawField(game_win, info.field);
+  drawField(game_win, info);
   drawNext(info_win, info.next);
   drawInfo(info_win, info);
 
-  if (game.state == GAME_START) {
+  EngineState_t state = engineState();
+  const int middle = info.height / 2, width = GAME_WINDOW_WIDTH(info.width);
+  if (state == ENGINE_START) {
     wattron(game_win, COLOR_PAIR(2));
-    mvwprintw(game_win, FIELD_HEIGHT / 2 - 1, (GAME_WINDOW_WIDTH - 10) / 2,
-              "WELCOME TO");
-    mvwprintw(game_win, FIELD_HEIGHT / 2, (GAME_WINDOW_WIDTH - 6) / 2,
-              "TETRIS");
-    mvwprintw(game_win, FIELD_HEIGHT / 2 + 2, (GAME_WINDOW_WIDTH - 10) / 2,
-              "Press S to");
-    mvwprintw(game_win, FIELD_HEIGHT / 2 + 3, (GAME_WINDOW_WIDTH - 5) / 2,
-              "START");
+    mvwprintw(game_win, middle - 1, (width - 10) / 2, "WELCOME TO");
+    mvwprintw(game_win, middle, (width - (int)strlen(title)) / 2, "%s", title);
+    mvwprintw(game_win, middle + 2, (width - 10) / 2, "Press S to");
+    mvwprintw(game_win, middle + 3, (width - 5) / 2, "START");
     wattroff(game_win, COLOR_PAIR(2));
-  } else if (game.state == GAME_OVER) {
+  } else if (state == ENGINE_OVER) {
     wattron(game_win, COLOR_PAIR(3));
-    mvwprintw(game_win, FIELD_HEIGHT / 2, (GAME_WINDOW_WIDTH - 9) / 2,
-              "GAME OVER");
-    mvwprintw(game_win, FIELD_HEIGHT / 2 + 1, (GAME_WINDOW_WIDTH - 7) / 2,
-              "Press S");
+    mvwprintw(game_win, middle, (width - 9) / 2, "GAME OVER");
+    mvwprintw(game_win, middle + 1, (width - 7) / 2, "Press S");
     wattroff(game_win, COLOR_PAIR(3));
   }
 
+  TRACE_BEGIN("wrefresh");
   wrefresh(game_win);
   wrefresh(info_win);
   refresh();
+  TRACE_END("wrefresh");
+  TRACE_END("drawGame");
 }
 
 int getInput(UserAction_t *action) {
@@ -176,18 +236,161 @@ int getInput(UserAction_t *action) {
   }
 }
 
-void gameLoop() {
-  extern Game_t game;
+// Ждет ввода не дольше ms мс; нажатие будит цикл сразу
+static void waitInput(int ms) {
+  struct pollfd input = {.fd = STDIN_FILENO, .events = POLLIN};
+  poll(&input, 1, ms);
+}
+
+// Сохраняет прерванную партию до выхода; true — партия сохранена
+static bool storeSession(const char *session_file) {
+  EngineState_t state = engineState();
+  if (state == ENGINE_PLAYING || state == ENGINE_PAUSED) {
+    return saveSession(session_file);
+  }
+  removeSession(session_file);
+  return false;
+}
+
+/**
+ * @brief Клавиша сдвига, которую интерфейс считает удерживаемой
+ */
+typedef struct {
+  UserAction_t action;
+  bool active;
+  bool repeating;   // Повтор клавиатуры начался — клавиша точно удерживается
+  int64_t pressed;  // Начало удержания, мс
+  int64_t seen;     // Последнее нажатие или повтор, мс
+} KeyHold_t;
+
+// Передает отпускание, если движок удерживает клавишу
+static void releaseKey(KeyHold_t *hold) {
+  if (hold->active && (hold->action != Down || hold->repeating)) {
+    userInput(hold->action, false);
+  }
+  hold->active = false;
+}
 
-  while (game.state != GAME_EXIT) {
+// Передает нажатие стрелки; повтор клавиатуры только продлевает удержание
+static void pressKey(KeyHold_t *hold, UserAction_t action, int64_t now) {
+  if (hold->active && hold->action == action &&
+      now - hold->pressed >= KEY_REPEAT_DELAY_MIN_MS) {
+    // Удерживаемый Down опускает фигуру построчно с первого повтора
+    if (!hold->repeating && action == Down) userInput(Down, true);
+    hold->repeating = true;
+    hold->seen = now;
+    return;
+  }
+  releaseKey(hold);
+  userInput(action, action != Down);
+  *hold = (KeyHold_t){action, true, false, now, now};
+}
+
+void gameLoop(const char *session_file, int repeat_delay) {
+  KeyHold_t hold = {0};
+  while (engineState() != ENGINE_EXIT) {
+    // Все накопившиеся нажатия применяются до отрисовки кадра
     UserAction_t action;
-    if (getInput(&action)) {
-      userInput(action, false);
+    while (engineState() != ENGINE_EXIT && getInput(&action)) {
+      int64_t arrival = probeNow();
+      // Сохраненная партия попадет в рекорды, когда закончится
+      if (action == Terminate && session_file && storeSession(session_file)) {
+        engineSuspend();
+        probeInput(arrival, engineVersion());
+        continue;
+      }
+      if (action == Left || action == Right || action == Down) {
+        pressKey(&hold, action, monotonicMs());
+      } else {
+        // Пауза и новая партия отпускают клавиши в движке сами
+        if (action != Action) hold.active = false;
+        userInput(action, false);
+      }
+      probeInput(arrival, engineVersion());
+    }
+    int64_t now = monotonicMs();
+    if (hold.active &&
+        (hold.repeating ? now - hold.seen > KEY_REPEAT_GAP_MS
+                        : now - hold.pressed > KEY_REPEAT_DELAY_MS +
+                                                   repeat_delay)) {
+      releaseKey(&hold);
     }
 
     GameInfo_t info = updateCurrentState();
+    uint64_t version = engineVersion();
+    spectatorPublish();
     drawGame(info);
+    probeFrame(version);
+    castFrame(info);
 
+    waitInput(1);
+  }
+}
+
+// Рисует обе игры сессии; игра потока временно подменяется и
+// возвращается из saved — буфера engineSnapshotSize() байт
+static void drawVersus(const VersusSession_t *session, WINDOW *remote_win,
+                       void *saved) {
+  engineSave(saved);
+
+  drawGame(versusView(session, VERSUS_LOCAL));
+
+  GameInfo_t remote = versusView(session, VERSUS_REMOTE);
+  werase(remote_win);
+  box(remote_win, 0, 0);
+  mvwprintw(remote_win, 0, 1, " RIVAL %d ", remote.score);
+  drawField(remote_win, remote);
+
+  int winner = versusWinner(session);
+  if (winner >= 0) {
+    static const char *results[] = {"YOU WIN", "YOU LOSE", "DRAW"};
+    wattron(info_win, COLOR_PAIR(3));
+    mvwprintw(info_win, 15, 2, "%s", results[winner]);
+    wattroff(info_win, COLOR_PAIR(3));
+    wrefresh(info_win);
+  }
+  wrefresh(remote_win);
+
+  engineLoad(saved);
+}
+
+void versusLoop(VersusSession_t *session, VersusLink_t *link) {
+  // Игра вдвоем идет на поле по умолчанию
+  WINDOW *remote_win =
+      newwin(GAME_WINDOW_HEIGHT(FIELD_HEIGHT), GAME_WINDOW_WIDTH(FIELD_WIDTH),
+             1, GAME_WINDOW_WIDTH(FIELD_WIDTH) + INFO_WINDOW_WIDTH + 3);
+  int64_t next_tick = monotonicMs();
+  VersusInput_t pending = 0;
+  // malloc выравнивает по max_align_t, как требует engineSave
+  void *saved = malloc(engineSnapshotSize());
+  bool running = saved != NULL;
+
+  while (running) {
+    // Нажатия копятся до ближайшего такта; пауза и старт в игре вдвоем
+    // не используются
+    UserAction_t action;
+    while (getInput(&action)) {
+      if (action == Terminate) {
+        running = false;
+      } else if (action != Start && action != Pause) {
+        pending |= (VersusInput_t)(1u << action);
+      }
+    }
+    if (versusPollInputs(link, session) < 0) running = false;
+
+    int64_t now = monotonicMs();
+    if (now - next_tick > VERSUS_CATCHUP_MS) next_tick = now;
+    while (running && versusWinner(session) < 0 && now >= next_tick &&
+           versusCanAdvance(session)) {
+      if (!versusSendInput(link, session->tick, pending)) running = false;
+      versusAdvance(session, pending);
+      pending = 0;
+      next_tick += VERSUS_TICK_MS;
+    }
+
+    drawVersus(session, remote_win, saved);
     napms(1);
   }
-}
\ No newline at end of file
+  free(saved);
+  delwin(remote_win);
+}
@@ -1,10 +1,187 @@
+#include <fcntl.h>
+
+#include "cast.h"
 #include "cli.h"
+#include "probe.h"
+#include "script.h"
+#include "session.h"
+#include "spectator.h"
+#include "trace.h"
+#include "versusui.h"
+
+// Кадр сценария уходит в трансляцию и запись, если они открыты
+static void scriptTick(GameInfo_t info) {
+  spectatorPublish();
+  castFrame(info);
+}
+
+// Подключается к сопернику или ждет его и ведет игру вдвоем
+static int runVersus(const char *path) {
+  VersusLink_t link = {.fd = versusConnect(path)};
+  if (link.fd < 0) {
+    fprintf(stderr, "Waiting for opponent on %s\n", path);
+    link.fd = versusListen(path);
+  }
+  uint32_t seed = (uint32_t)time(NULL) ^ (uint32_t)getpid() << 16;
+  uint32_t remote_seed;
+  if (link.fd < 0 || !versusHandshake(link.fd, seed, &remote_seed)) {
+    fprintf(stderr, "Cannot connect to opponent on %s\n", path);
+    if (link.fd >= 0) close(link.fd);
+    return 1;
+  }
 
-int main() {
+  // Откат может повторно просчитать конец игры — рекорды не пишем
+  setLeaderboardFile(NULL);
+  static VersusSession_t session;
+  versusInit(&session, seed, remote_seed);
   initInterface();
-  initGame();
-  gameLoop();
+  versusLoop(&session, &link);
   cleanupInterface();
-  freeGame();
+  close(link.fd);
   return 0;
+}
+
+int main(int argc, char **argv) {
+  // --publish [ИМЯ] — транслировать кадры в разделяемую память
+  // --script [ФАЙЛ] — управление потоком действий из файла или stdin
+  // --versus СОКЕТ — игра вдвоем через локальный сокет
+  // --cast ФАЙЛ — запись игры или сценария в формате asciicast
+  // --probe ФАЙЛ — замер задержки от ввода до вывода, отчет в файл
+  // --session ФАЙЛ — где сохранять прерванную партию (session.dat)
+  // --size ШxВ — размер поля новой партии, по умолчанию 10x20
+  // --repeat ЗАДЕРЖКА,ИНТЕРВАЛ — автоповтор удерживаемого сдвига, мс
+  // --seed N — зерно фигур первой партии, по умолчанию от времени и pid
+  const char *feed_name = NULL;
+  const char *script_path = NULL;
+  const char *versus_path = NULL;
+  const char *cast_path = NULL;
+  const char *probe_path = NULL;
+  const char *session_path = SESSION_FILE;
+  int width = FIELD_WIDTH, height = FIELD_HEIGHT;
+  int repeat_delay = ENGINE_REPEAT_DELAY_MS;
+  int repeat_interval = ENGINE_REPEAT_INTERVAL_MS;
+  uint32_t seed = (uint32_t)time(NULL) ^ (uint32_t)getpid() << 16;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--publish") == 0) {
+      feed_name = i + 1 < argc && argv[i + 1][0] == '/' ? argv[++i]
+                                                        : SPECTATOR_FEED_NAME;
+    } else if (strcmp(argv[i], "--script") == 0) {
+      script_path = i + 1 < argc && argv[i + 1][0] != '-' ? argv[++i] : "-";
+    } else if (strcmp(argv[i], "--versus") == 0 && i + 1 < argc) {
+      versus_path = argv[++i];
+    } else if (strcmp(argv[i], "--cast") == 0 && i + 1 < argc) {
+      cast_path = argv[++i];
+    } else if (strcmp(argv[i], "--probe") == 0 && i + 1 < argc) {
+      probe_path = argv[++i];
+    } else if (strcmp(argv[i], "--session") == 0 && i + 1 < argc) {
+      session_path = argv[++i];
+    } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+      if (sscanf(argv[++i], "%dx%d", &width, &height) != 2) width = 0;
+    } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc &&
+               sscanf(argv[i + 1], "%d,%d", &repeat_delay,
+                      &repeat_interval) == 2 &&
+               repeat_delay > 0 && repeat_interval > 0) {
+      i++;
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc &&
+               sscanf(argv[i + 1], "%u", &seed) == 1) {
+      i++;
+    } else {
+      fprintf(stderr,
+              "Usage: %s [--publish [/NAME]] [--script [FILE]] "
+              "[--versus SOCKET] [--cast FILE] [--probe FILE] "
+              "[--session FILE] [--size WxH] [--repeat DELAY,INTERVAL] "
+              "[--seed N]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  // Трансляция и игра вдвоем идут только на поле по умолчанию
+  bool resized = width != FIELD_WIDTH || height != FIELD_HEIGHT;
+  if (width < FIELD_SIZE_MIN || width > FIELD_WIDTH_MAX ||
+      height < FIELD_SIZE_MIN || height > FIELD_HEIGHT_MAX) {
+    fprintf(stderr, "Board size must be from %dx%d to %dx%d\n",
+            FIELD_SIZE_MIN, FIELD_SIZE_MIN, FIELD_WIDTH_MAX, FIELD_HEIGHT_MAX);
+    return 1;
+  }
+  if (resized && (feed_name || versus_path)) {
+    fprintf(stderr, "--size cannot be combined with --publish or --versus\n");
+    return 1;
+  }
+  int script_fd = -1;
+  if (script_path) {
+    script_fd = strcmp(script_path, "-") == 0 ? STDIN_FILENO
+                                              : open(script_path, O_RDONLY);
+    if (script_fd < 0) {
+      fprintf(stderr, "Cannot open script %s\n", script_path);
+      return 1;
+    }
+  }
+  if (probe_path && !probeOpen(probe_path)) {
+    fprintf(stderr, "Cannot create probe report %s\n", probe_path);
+    return 1;
+  }
+  if (feed_name && !spectatorOpen(feed_name)) {
+    fprintf(stderr, "Cannot create spectator feed %s\n", feed_name);
+    probeClose();
+    return 1;
+  }
+
+  int status = 0;
+  if (versus_path) {
+    status = runVersus(versus_path);
+  } else if (script_fd >= 0 && cast_path &&
+             !castOpen(cast_path, CAST_FRAME_MS, &seed)) {
+    fprintf(stderr, "Cannot create cast %s\n", cast_path);
+    status = 1;
+  } else if (script_fd >= 0) {
+    ScriptStats_t stats = {0};
+    // Генераторы нагрузки не должны попадать в рекорды игрока
+    setLeaderboardFile(NULL);
+    setScriptTickHook(scriptTick);
+    // При экспорте сценария игровое время идет только по тикам
+    if (cast_path) setScriptTickStep(CAST_FRAME_MS);
+    engineInit();
+    engineResize(width, height);
+    engineAutoRepeat(repeat_delay, repeat_interval);
+    engineNewGame(seed);
+    status = runScript(script_fd, &stats) == 0 ? 0 : 1;
+    castClose();
+    if (script_fd != STDIN_FILENO) close(script_fd);
+    char summary[ENGINE_STATUS_SIZE];
+    engineStatus(summary, sizeof(summary));
+    fprintf(stderr, "actions %ld ticks %ld invalid %ld %s seconds %.3f\n",
+            stats.actions, stats.ticks, stats.invalid, summary,
+            stats.seconds);
+    engineFree();
+  } else {
+    engineInit();
+    engineResize(width, height);
+    engineAutoRepeat(repeat_delay, repeat_interval);
+    engineNewGame(seed);
+    // Прерванная партия продолжается с паузы и со своей очередью фигур
+    bool resumed = loadSession(session_path);
+    if (resumed && engineState() == ENGINE_PLAYING) userInput(Pause, false);
+    initInterface();
+    bool casting = !cast_path || castOpen(cast_path, 0, resumed ? NULL : &seed);
+    if (casting) {
+      gameLoop(session_path, repeat_delay);
+      castClose();
+    }
+    cleanupInterface();
+    if (!casting) {
+      fprintf(stderr, "Cannot create cast %s\n", cast_path);
+      status = 1;
+    }
+    engineFree();
+  }
+  spectatorClose();
+  if (!probeClose()) {
+    fprintf(stderr, "Cannot write probe report %s\n", probe_path);
+    status = 1;
+  }
+#ifdef TETRIS_TRACE
+  const char *trace_file = getenv("TETRIS_TRACE_FILE");
+  traceWrite(trace_file ? trace_file : TRACE_FILE);
+#endif
+  return status;
 }
\ No newline at end of file
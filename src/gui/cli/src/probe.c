@@ -0,0 +1,97 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "probe.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#include "histogram.h"
+
+#define PROBE_VERSION 1
+
+/**
+ * @brief Ввод, ждущий кадра
+ */
+typedef struct {
+  int64_t arrival_ns;
+  uint64_t version;
+} ProbeInput_t;
+
+static FILE *report;
+static Histogram_t latency;  // Задержки, нс
+static ProbeInput_t pending[PROBE_PENDING_MAX];
+static long pending_head;  // Индекс старейшего ожидающего ввода
+static long pending_count;
+static long dropped;  // Вводы, не поместившиеся в очередь
+static long frames;
+
+int64_t probeNow(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+bool probeOpen(const char *path) {
+  if (report) return false;
+  report = fopen(path, "w");
+  histogramReset(&latency);
+  pending_head = pending_count = dropped = frames = 0;
+  return report != NULL;
+}
+
+void probeInput(int64_t arrival_ns, uint64_t version) {
+  if (!report) return;
+  if (pending_count == PROBE_PENDING_MAX) {
+    dropped++;
+    return;
+  }
+  pending[(pending_head + pending_count) % PROBE_PENDING_MAX] =
+      (ProbeInput_t){arrival_ns, version};
+  pending_count++;
+}
+
+void probeFrame(uint64_t version) {
+  if (!report) return;
+  frames++;
+  // Версии растут, поэтому отражены всегда самые старые вводы очереди
+  int64_t now = probeNow();
+  while (pending_count && pending[pending_head].version <= version) {
+    histogramAdd(&latency, now - pending[pending_head].arrival_ns);
+    pending_head = (pending_head + 1) % PROBE_PENDING_MAX;
+    pending_count--;
+  }
+}
+
+static double microseconds(long long ns) { return (double)ns / 1000.0; }
+
+bool probeClose(void) {
+  if (!report) return true;
+  fprintf(report, "{\n");
+  fprintf(report, "  \"probe\": \"input-to-display\",\n");
+  fprintf(report, "  \"version\": %d,\n", PROBE_VERSION);
+  fprintf(report, "  \"inputs\": %ld,\n", latency.count);
+  fprintf(report, "  \"frames\": %ld,\n", frames);
+  fprintf(report, "  \"unanswered\": %ld,\n", pending_count);
+  fprintf(report, "  \"dropped\": %ld,\n", dropped);
+  fprintf(report,
+          "  \"latency_us\": {\"p50\": %.1f, \"p90\": %.1f, "
+          "\"p99\": %.1f, \"max\": %.1f},\n",
+          microseconds(histogramPercentile(&latency, 0.50)),
+          microseconds(histogramPercentile(&latency, 0.90)),
+          microseconds(histogramPercentile(&latency, 0.99)),
+          microseconds(latency.max));
+  // Непустые корзины: нижняя граница и число вводов
+  fprintf(report, "  \"histogram_us\": [");
+  const char *separator = "";
+  for (int i = 0; i < HISTOGRAM_SIZE; i++) {
+    if (!latency.counts[i]) continue;
+    fprintf(report, "%s[%.1f, %ld]", separator,
+            microseconds(histogramBucketValue(i)), latency.counts[i]);
+    separator = ", ";
+  }
+  fprintf(report, "]\n}\n");
+  bool written = !ferror(report);
+  written = fclose(report) == 0 && written;
+  report = NULL;
+  return written;
+}
@@ -0,0 +1,71 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "brick_game.h"
+
+#define FRAME_GAME_WIDTH 22  // Окно поля по умолчанию, как в терминале
+#define FRAME_INFO_WIDTH 20
+#define FRAME_BOX_HEIGHT 22
+#define FRAME_WIDTH (FRAME_GAME_WIDTH + FRAME_INFO_WIDTH + 2)
+#define FRAME_HEIGHT (FRAME_BOX_HEIGHT + 1)
+#define FRAME_BUFFER_SIZE 16384  // Больше полной перерисовки кадра
+
+/**
+ * @brief Цвета клеток кадра
+ */
+typedef enum {
+  FRAME_COLOR_DEFAULT,
+  FRAME_COLOR_TITLE,   // Приветствие
+  FRAME_COLOR_ALERT,   // Пауза и конец игры
+  FRAME_COLOR_CELL,    // FRAME_COLOR_CELL + вид - 1 — цвет клетки поля
+  FRAME_COLOR_COUNT = FRAME_COLOR_CELL + ENGINE_CELL_KINDS_MAX
+} FrameColor_t;
+
+/**
+ * @brief Клетка экрана
+ */
+typedef struct {
+  char ch;
+  uint8_t color;  // FrameColor_t
+} FrameCell_t;
+
+/**
+ * @brief Экран клиента в раскладке drawGame
+ */
+typedef struct {
+  FrameCell_t cells[FRAME_HEIGHT][FRAME_WIDTH];
+} Frame_t;
+
+/**
+ * @brief Заполняет кадр пробелами цвета по умолчанию — так выглядит
+ * очищенный экран
+ * @param frame Кадр
+ */
+void frameClear(Frame_t *frame);
+
+/**
+ * @brief Рисует игру текущего потока в кадр
+ * @param frame Кадр
+ * @param info Состояние игры
+ */
+void frameRender(Frame_t *frame, GameInfo_t info);
+
+/**
+ * @brief Записывает ANSI-последовательности, переводящие экран из before
+ * в after
+ *
+ * Выводятся только изменившиеся клетки; курсор переставляется лишь перед
+ * разрывом в строке, цвет — при смене.
+ * @param before Кадр на экране клиента
+ * @param after Новый кадр
+ * @param out Буфер вывода
+ * @param size Размер буфера
+ * @return Количество байт или -1, если буфер мал
+ */
+long frameDiff(const Frame_t *before, const Frame_t *after, char *out,
+               size_t size);
+
+#endif  // FRAME_H
@@ -0,0 +1,163 @@
+#include "frame.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// SGR по цветам кадра; цвета клеток берутся из палитры движка
+static const char *const sgr[FRAME_COLOR_CELL] = {"\x1b[0m", "\x1b[0;36m",
+                                                  "\x1b[0;37;41m"};
+
+// Пишет SGR цвета color, возвращает длину
+static int writeColor(char *out, size_t size, int color) {
+  if (color < FRAME_COLOR_CELL) return snprintf(out, size, "%s", sgr[color]);
+  EngineColors_t colors = engineInfo()->palette[color - FRAME_COLOR_CELL];
+  // Черный фон — фон терминала
+  return colors.bg == ENGINE_BLACK
+             ? snprintf(out, size, "\x1b[0;%dm", 30 + colors.fg)
+             : snprintf(out, size, "\x1b[0;%d;%dm", 30 + colors.fg,
+                        40 + colors.bg);
+}
+
+void frameClear(Frame_t *frame) {
+  for (int y = 0; y < FRAME_HEIGHT; y++) {
+    for (int x = 0; x < FRAME_WIDTH; x++) {
+      frame->cells[y][x] = (FrameCell_t){' ', FRAME_COLOR_DEFAULT};
+    }
+  }
+}
+
+static void put(Frame_t *frame, int y, int x, char ch, int color) {
+  if (y >= 0 && y < FRAME_HEIGHT && x >= 0 && x < FRAME_WIDTH) {
+    frame->cells[y][x] = (FrameCell_t){ch, (uint8_t)color};
+  }
+}
+
+static void text(Frame_t *frame, int y, int x, const char *s, int color) {
+  for (; *s; s++, x++) put(frame, y, x, *s, color);
+}
+
+// Рамка окна с заголовком, как box и mvwprintw(win, 0, 1, title)
+static void box(Frame_t *frame, int top, int left, int width,
+                const char *title) {
+  int bottom = top + FRAME_BOX_HEIGHT - 1, right = left + width - 1;
+  for (int x = left + 1; x < right; x++) {
+    put(frame, top, x, '-', FRAME_COLOR_DEFAULT);
+    put(frame, bottom, x, '-', FRAME_COLOR_DEFAULT);
+  }
+  for (int y = top + 1; y < bottom; y++) {
+    put(frame, y, left, '|', FRAME_COLOR_DEFAULT);
+    put(frame, y, right, '|', FRAME_COLOR_DEFAULT);
+  }
+  put(frame, top, left, '+', FRAME_COLOR_DEFAULT);
+  put(frame, top, right, '+', FRAME_COLOR_DEFAULT);
+  put(frame, bottom, left, '+', FRAME_COLOR_DEFAULT);
+  put(frame, bottom, right, '+', FRAME_COLOR_DEFAULT);
+  text(frame, top, left + 1, title, FRAME_COLOR_DEFAULT);
+}
+
+static void cell(Frame_t *frame, int x, int y, int color, char left,
+                 char right) {
+  put(frame, y + 2, x * 2 + 2, left, color);
+  put(frame, y + 2, x * 2 + 3, right, color);
+}
+
+void frameRender(Frame_t *frame, GameInfo_t info) {
+  frameClear(frame);
+  const char *title = engineInfo()->title;
+  char caption[FRAME_GAME_WIDTH];
+  snprintf(caption, sizeof(caption), " %s ", title);
+  const int info_left = FRAME_GAME_WIDTH + 2;
+  box(frame, 1, 1, FRAME_GAME_WIDTH, caption);
+  box(frame, 1, info_left, FRAME_INFO_WIDTH, " INFO ");
+
+  for (int y = 0; y < info.height; y++) {
+    for (int x = 0; x < info.width; x++) {
+      Cell_t value = info.field[y][x];
+      if (value != CELL_EMPTY) {
+        cell(frame, x, y, FRAME_COLOR_CELL + value - 1, '[', ']');
+      }
+    }
+  }
+  EngineCell_t active[ENGINE_ACTIVE_MAX];
+  int count = engineActiveCells(active);
+  for (int i = 0; i < count; i++) {
+    cell(frame, active[i].x, active[i].y, FRAME_COLOR_CELL + active[i].cell - 1,
+         '{', '}');
+  }
+
+  // Информационная панель повторяет drawNext и drawInfo
+  text(frame, 3, info_left + 2, "NEXT:", FRAME_COLOR_DEFAULT);
+  for (int y = 0; y < NEXT_SIZE && info.next; y++) {
+    for (int x = 0; x < NEXT_SIZE; x++) {
+      if (info.next[y][x]) {
+        put(frame, y + 5, info_left + x * 2 + 2, '{', FRAME_COLOR_DEFAULT);
+        put(frame, y + 5, info_left + x * 2 + 3, '}', FRAME_COLOR_DEFAULT);
+      }
+    }
+  }
+  char line[FRAME_INFO_WIDTH];
+  const struct {
+    const char *label;
+    int value;
+  } stats[] = {{"SCORE", info.score},
+               {"HIGH", info.high_score},
+               {"LEVEL", info.level},
+               {"SPEED", info.speed}};
+  for (int i = 0; i < 4; i++) {
+    snprintf(line, sizeof(line), "%s: %d", stats[i].label, stats[i].value);
+    text(frame, 11 + i, info_left + 2, line, FRAME_COLOR_DEFAULT);
+  }
+  if (info.pause) {
+    text(frame, 16, info_left + 2, "PAUSED", FRAME_COLOR_ALERT);
+  }
+  text(frame, 18, info_left + 2, "Controls:", FRAME_COLOR_DEFAULT);
+  text(frame, 19, info_left + 2, "S - Start", FRAME_COLOR_DEFAULT);
+  text(frame, 20, info_left + 2, "P - Pause", FRAME_COLOR_DEFAULT);
+  text(frame, 21, info_left + 2, "Q - Quit", FRAME_COLOR_DEFAULT);
+
+  const int middle = 1 + info.height / 2;
+  EngineState_t state = engineState();
+  if (state == ENGINE_START) {
+    text(frame, middle - 1, 1 + (FRAME_GAME_WIDTH - 10) / 2, "WELCOME TO",
+         FRAME_COLOR_TITLE);
+    text(frame, middle, 1 + (FRAME_GAME_WIDTH - (int)strlen(title)) / 2, title,
+         FRAME_COLOR_TITLE);
+    text(frame, middle + 2, 1 + (FRAME_GAME_WIDTH - 10) / 2, "Press S to",
+         FRAME_COLOR_TITLE);
+    text(frame, middle + 3, 1 + (FRAME_GAME_WIDTH - 5) / 2, "START",
+         FRAME_COLOR_TITLE);
+  } else if (state == ENGINE_OVER) {
+    text(frame, middle, 1 + (FRAME_GAME_WIDTH - 9) / 2, "GAME OVER",
+         FRAME_COLOR_ALERT);
+    text(frame, middle + 1, 1 + (FRAME_GAME_WIDTH - 7) / 2, "Press S",
+         FRAME_COLOR_ALERT);
+  }
+}
+
+long frameDiff(const Frame_t *before, const Frame_t *after, char *out,
+               size_t size) {
+  size_t length = 0;
+  int color = -1;  // Цвет терминала до первого изменения неизвестен
+  for (int y = 0; y < FRAME_HEIGHT; y++) {
+    int cursor = -1;  // Столбец курсора в этой строке, -1 — не здесь
+    for (int x = 0; x < FRAME_WIDTH; x++) {
+      FrameCell_t next = after->cells[y][x];
+      FrameCell_t prev = before->cells[y][x];
+      if (next.ch == prev.ch && next.color == prev.color) continue;
+
+      // Самая длинная вставка: переход курсора, SGR и символ
+      if (length + 32 > size) return -1;
+      if (cursor != x) {
+        length += (size_t)snprintf(out + length, size - length, "\x1b[%d;%dH",
+                                   y + 1, x + 1);
+      }
+      if (next.color != color) {
+        length += (size_t)writeColor(out + length, size - length, next.color);
+        color = next.color;
+      }
+      out[length++] = next.ch;
+      cursor = x + 1;
+    }
+  }
+  return (long)length;
+}
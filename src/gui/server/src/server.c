@@ -0,0 +1,455 @@
+#define _GNU_SOURCE
+
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "brick_game.h"
+#include "frame.h"
+#include "gameclock.h"
+#include "script.h"
+#include "timerwheel.h"
+
+#define DEFAULT_PORT 4000
+#define DEFAULT_SESSIONS 512
+#define MAX_LISTENERS 2
+#define MAX_EVENTS 64
+#define READ_SIZE 512
+
+// Вывод при подключении и отключении: скрыть курсор и очистить экран
+#define SCREEN_OPEN "\x1b[?25l\x1b[0m\x1b[2J"
+#define SCREEN_CLOSE "\x1b[0m\x1b[2J\x1b[H\x1b[?25h"
+// Telnet: сервер сам отображает ввод и не ждет конца строки
+#define TELNET_CHAR_MODE "\xff\xfb\x01\xff\xfb\x03"
+
+enum { TELNET_IAC = 255, TELNET_SB = 250, TELNET_SE = 240, TELNET_WILL = 251 };
+
+typedef enum { SOURCE_LISTENER, SOURCE_SESSION } SourceKind_t;
+
+/**
+ * @brief Разбор telnet-команд и escape-последовательностей клавиш
+ */
+typedef enum {
+  INPUT_TEXT,
+  INPUT_IAC,          // После IAC
+  INPUT_IAC_OPTION,   // После WILL/WONT/DO/DONT ждем номер опции
+  INPUT_SUBOPTION,    // Внутри SB ... IAC SE
+  INPUT_SUBOPTION_IAC,
+  INPUT_ESCAPE,       // После ESC
+  INPUT_CSI           // После ESC [ или ESC O
+} InputState_t;
+
+typedef struct {
+  SourceKind_t kind;
+  int fd;
+} Listener_t;
+
+/**
+ * @brief Игра одного клиента
+ */
+typedef struct {
+  SourceKind_t kind;
+  int fd;
+  TimerNode_t gravity;  // Ближайшее изменение игры без ввода
+  uint64_t clock_ms;    // Момент, до которого просчитана игра
+  InputState_t input;
+  bool dirty;           // Кадр ждет освобождения буфера вывода
+  bool waiting;         // Ожидается EPOLLOUT
+  Frame_t screen;       // Что видит клиент после отправки out
+  char out[FRAME_BUFFER_SIZE];
+  size_t out_length;
+  size_t out_sent;
+  _Alignas(max_align_t) unsigned char game[];  // Снимок engineSave
+} Session_t;
+
+static volatile sig_atomic_t stopping;
+static int epoll_fd;
+static TimerWheel_t wheel;
+static unsigned char *session_memory;  // Блоки всех сессий подряд
+static Session_t **idle_sessions;     // Стек свободных блоков
+static int idle_count;
+static int session_count;
+static bool telnet;
+static uint32_t next_seed;
+
+static void onSignal(int signal) {
+  (void)signal;
+  stopping = 1;
+}
+
+static void watch(int fd, void *source, uint32_t events, int operation) {
+  struct epoll_event event = {.events = events, .data.ptr = source};
+  epoll_ctl(epoll_fd, operation, fd, &event);
+}
+
+// Отправляет накопленный вывод; остаток ждет EPOLLOUT
+static bool flush(Session_t *session) {
+  while (session->out_sent < session->out_length) {
+    ssize_t sent = send(session->fd, session->out + session->out_sent,
+                        session->out_length - session->out_sent, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) continue;
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (!session->waiting) {
+        watch(session->fd, session, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD);
+        session->waiting = true;
+      }
+      return true;
+    }
+    if (sent <= 0) return false;
+    session->out_sent += (size_t)sent;
+  }
+  if (session->waiting) {
+    watch(session->fd, session, EPOLLIN, EPOLL_CTL_MOD);
+    session->waiting = false;
+  }
+  session->out_length = session->out_sent = 0;
+  return true;
+}
+
+// Дописывает к выводу разницу с последним кадром клиента. Пока предыдущий
+// вывод не ушел, кадр откладывается: медленный клиент получит сразу итог
+static bool render(Session_t *session, GameInfo_t info) {
+  if (session->out_length) {
+    session->dirty = true;
+    return true;
+  }
+  Frame_t frame;
+  frameRender(&frame, info);
+  long length =
+      frameDiff(&session->screen, &frame, session->out, sizeof(session->out));
+  if (length <= 0) return length == 0;
+  session->screen = frame;
+  session->out_length = (size_t)length;
+  session->dirty = false;
+  return flush(session);
+}
+
+// Ставит таймер на ближайшее изменение игры потока без ввода
+static void schedule(Session_t *session) {
+  int64_t due = engineTimeout();
+  if (due < 0) {
+    timerWheelCancel(&wheel, &session->gravity);
+    return;
+  }
+  timerWheelAdd(&wheel, &session->gravity, session->clock_ms + (uint64_t)due);
+}
+
+// Просчитывает игру сессии до now после ввода или срабатывания таймера
+static GameInfo_t advance(Session_t *session, uint64_t now) {
+  GameInfo_t info = engineStep((int)(now - session->clock_ms));
+  session->clock_ms = now;
+  schedule(session);
+  return info;
+}
+
+static void closeSession(Session_t *session) {
+  timerWheelCancel(&wheel, &session->gravity);
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, session->fd, NULL);
+  close(session->fd);
+  idle_sessions[idle_count++] = session;
+  session_count--;
+}
+
+static void openSession(int fd, uint64_t now) {
+  Session_t *session = idle_count ? idle_sessions[--idle_count] : NULL;
+  if (!session) {
+    static const char full[] = "Server is full\r\n";
+    if (send(fd, full, sizeof(full) - 1, MSG_NOSIGNAL) < 0) {
+      // Клиент уже отключился — закрываем в любом случае
+    }
+    close(fd);
+    return;
+  }
+  memset(session, 0, sizeof(Session_t));
+  session->kind = SOURCE_SESSION;
+  session->fd = fd;
+  session->clock_ms = now;
+  frameClear(&session->screen);
+
+  engineNewGame(next_seed++ * 2654435761u ^ (uint32_t)now);
+
+  const char *greeting = telnet ? TELNET_CHAR_MODE SCREEN_OPEN : SCREEN_OPEN;
+  session->out_length = strlen(greeting);
+  memcpy(session->out, greeting, session->out_length);
+  watch(fd, session, EPOLLIN, EPOLL_CTL_ADD);
+  session_count++;
+  // Приветствие уходит вместе с первым кадром
+  bool alive = flush(session) && render(session, advance(session, now));
+  engineSave(session->game);
+  if (!alive) closeSession(session);
+}
+
+static void acceptClients(Listener_t *listener, uint64_t now) {
+  for (;;) {
+    int fd = accept4(listener->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+    openSession(fd, now);
+  }
+}
+
+// Переводит байт ввода в действие с учетом telnet и стрелок
+static bool decode(Session_t *session, unsigned char byte,
+                   UserAction_t *action) {
+  switch (session->input) {
+    case INPUT_IAC:
+      // IAC IAC — байт 255 как данные, он ничего не значит
+      session->input = byte == TELNET_SB ? INPUT_SUBOPTION
+                       : byte >= TELNET_WILL && byte != TELNET_IAC
+                           ? INPUT_IAC_OPTION
+                           : INPUT_TEXT;
+      return false;
+    case INPUT_IAC_OPTION:
+      session->input = INPUT_TEXT;
+      return false;
+    case INPUT_SUBOPTION:
+      if (byte == TELNET_IAC) session->input = INPUT_SUBOPTION_IAC;
+      return false;
+    case INPUT_SUBOPTION_IAC:
+      session->input = byte == TELNET_SE ? INPUT_TEXT : INPUT_SUBOPTION;
+      return false;
+    case INPUT_ESCAPE:
+      session->input = byte == '[' || byte == 'O' ? INPUT_CSI : INPUT_TEXT;
+      return false;
+    case INPUT_CSI: {
+      session->input = INPUT_TEXT;
+      static const char arrows[] = "ABCD";
+      static const UserAction_t arrow_actions[] = {Up, Down, Right, Left};
+      const char *found = byte ? strchr(arrows, byte) : NULL;
+      if (found) *action = arrow_actions[found - arrows];
+      return found != NULL;
+    }
+    case INPUT_TEXT:
+      break;
+  }
+  if (byte == TELNET_IAC) {
+    session->input = INPUT_IAC;
+    return false;
+  }
+  if (byte == 0x1b) {
+    session->input = INPUT_ESCAPE;
+    return false;
+  }
+  if (byte == ' ') {
+    *action = Action;
+    return true;
+  }
+  // Буквы — как в сценариях: s p q l r u d a
+  return scriptAction((char)tolower(byte), action);
+}
+
+// Возвращает false, если сессию нужно закрыть
+static bool readInput(Session_t *session, uint64_t now) {
+  unsigned char buffer[READ_SIZE];
+  ssize_t size = recv(session->fd, buffer, sizeof(buffer), 0);
+  if (size < 0) return errno == EAGAIN || errno == EINTR;
+  if (size == 0) return false;
+
+  GameInfo_t info = advance(session, now);
+  for (ssize_t i = 0; i < size; i++) {
+    UserAction_t action;
+    if (!decode(session, buffer[i], &action)) continue;
+    userInput(action, false);
+    if (action == Terminate) return false;
+    info = advance(session, now);
+  }
+  return render(session, info);
+}
+
+static void onGravity(TimerNode_t *timer, void *context) {
+  Session_t *session =
+      (Session_t *)((char *)timer - offsetof(Session_t, gravity));
+  uint64_t now = *(const uint64_t *)context;
+  engineLoad(session->game);
+  bool alive = render(session, advance(session, now));
+  engineSave(session->game);
+  if (!alive) closeSession(session);
+}
+
+static void handleSession(Session_t *session, uint32_t events, uint64_t now) {
+  engineLoad(session->game);
+  bool alive = !(events & (EPOLLERR | EPOLLHUP)) || (events & EPOLLIN);
+  if (alive && (events & EPOLLOUT)) {
+    alive = flush(session) &&
+            (!session->dirty || render(session, advance(session, now)));
+  }
+  if (alive && (events & EPOLLIN)) alive = readInput(session, now);
+  engineSave(session->game);
+  if (!alive) {
+    if (send(session->fd, SCREEN_CLOSE, sizeof(SCREEN_CLOSE) - 1,
+             MSG_NOSIGNAL | MSG_DONTWAIT) < 0) {
+      // Прощальный вывод необязателен
+    }
+    closeSession(session);
+  }
+}
+
+static int listenTcp(const char *spec) {
+  char host[64] = "127.0.0.1";
+  const char *colon = strrchr(spec, ':');
+  const char *port = spec;
+  if (colon) {
+    size_t length = (size_t)(colon - spec);
+    if (length >= sizeof(host)) return -1;
+    memcpy(host, spec, length);
+    host[length] = '\0';
+    port = colon + 1;
+  }
+  struct sockaddr_in address = {.sin_family = AF_INET,
+                                .sin_port = htons((uint16_t)atoi(port))};
+  if (inet_pton(AF_INET, host, &address.sin_addr) != 1) return -1;
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  int yes = 1;
+  if (fd < 0 ||
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0 ||
+      bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    if (fd >= 0) close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int listenUnix(const char *path) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof(address.sun_path)) return -1;
+  strcpy(address.sun_path, path);
+  unlink(path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0 || bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    if (fd >= 0) close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static void printUsage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [--tcp [HOST:]PORT] [--unix PATH] [--sessions N] "
+          "[--telnet]\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  const char *tcp = NULL;
+  const char *unix_path = NULL;
+  int capacity = DEFAULT_SESSIONS;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) {
+      tcp = argv[++i];
+    } else if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc) {
+      unix_path = argv[++i];
+    } else if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+      capacity = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--telnet") == 0) {
+      telnet = true;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (capacity < 1) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  static char default_tcp[16];
+  if (!tcp && !unix_path) {
+    snprintf(default_tcp, sizeof(default_tcp), "%d", DEFAULT_PORT);
+    tcp = default_tcp;
+  }
+
+  // Партии клиентов не принадлежат владельцу сервера, а запись рекорда —
+  // блокирующий ввод-вывод посреди цикла всех сессий
+  engineRecordResults(false);
+
+  // Все сессии размечаются заранее; подключение берет блок из стека за O(1).
+  // Игра сессии хранится снимком движка сразу за Session_t
+  engineInit();
+  size_t align = alignof(max_align_t);
+  size_t session_size =
+      (sizeof(Session_t) + engineSnapshotSize() + align - 1) / align * align;
+  session_memory = calloc((size_t)capacity, session_size);
+  idle_sessions = calloc((size_t)capacity, sizeof(Session_t *));
+  if (!session_memory || !idle_sessions) {
+    fprintf(stderr, "Cannot allocate %d sessions\n", capacity);
+    return 1;
+  }
+  // Первыми выдаются блоки из начала памяти
+  for (int i = capacity - 1; i >= 0; i--) {
+    idle_sessions[idle_count++] =
+        (Session_t *)(session_memory + (size_t)i * session_size);
+  }
+
+  static Listener_t listeners[MAX_LISTENERS];
+  int listener_count = 0;
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (tcp) {
+    listeners[listener_count] =
+        (Listener_t){SOURCE_LISTENER, listenTcp(tcp)};
+    if (listeners[listener_count].fd < 0) {
+      fprintf(stderr, "Cannot listen on %s\n", tcp);
+      return 1;
+    }
+    listener_count++;
+  }
+  if (unix_path) {
+    listeners[listener_count] =
+        (Listener_t){SOURCE_LISTENER, listenUnix(unix_path)};
+    if (listeners[listener_count].fd < 0) {
+      fprintf(stderr, "Cannot listen on %s\n", unix_path);
+      return 1;
+    }
+    listener_count++;
+  }
+  for (int i = 0; i < listener_count; i++) {
+    watch(listeners[i].fd, &listeners[i], EPOLLIN, EPOLL_CTL_ADD);
+  }
+
+  struct sigaction action = {.sa_handler = onSignal};
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  fprintf(stderr, "Serving up to %d sessions\n", capacity);
+
+  timerWheelInit(&wheel, (uint64_t)monotonicMs());
+  struct epoll_event events[MAX_EVENTS];
+  while (!stopping) {
+    // Ожидание ограничено только ближайшим таймером: без игр в движении
+    // цикл спит, пока не придет ввод
+    int64_t timeout = timerWheelTimeout(&wheel);
+    int count = epoll_wait(epoll_fd, events, MAX_EVENTS,
+                           timeout > INT32_MAX ? INT32_MAX : (int)timeout);
+    if (count < 0 && errno != EINTR) break;
+
+    uint64_t now = (uint64_t)monotonicMs();
+    for (int i = 0; i < count; i++) {
+      SourceKind_t *kind = events[i].data.ptr;
+      if (*kind == SOURCE_LISTENER) {
+        acceptClients((Listener_t *)kind, now);
+      } else {
+        handleSession((Session_t *)kind, events[i].events, now);
+      }
+    }
+    timerWheelAdvance(&wheel, now, onGravity, &now);
+  }
+
+  for (int i = 0; i < listener_count; i++) close(listeners[i].fd);
+  if (unix_path) unlink(unix_path);
+  close(epoll_fd);
+  free(idle_sessions);
+  free(session_memory);
+  engineFree();
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <ncurses.h>
+#include <string.h>
+
+#include "spectator.h"
+
+#define VIEW_FIELD_WIDTH (FIELD_WIDTH * 2 + 2)
+#define VIEW_FIELD_HEIGHT (FIELD_HEIGHT + 2)
+#define VIEW_INFO_WIDTH 20
+#define POLL_MS 16       // Период опроса трансляции, мс
+#define ATTACH_POLLS 30  // Повтор подключения примерно раз в 0.5 с
+
+static WINDOW *field_win;
+static WINDOW *info_win;
+
+static void drawPiece(WINDOW *win, int type, int rotation, int left, int top,
+                      bool clip) {
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      if (!getTetrominoBlock(type, rotation, x, y)) continue;
+      int cx = left + x, cy = top + y;
+      if (clip && (cx < 0 || cx >= FIELD_WIDTH || cy < 0 ||
+                   cy >= FIELD_HEIGHT)) {
+        continue;
+      }
+      mvwaddch(win, cy + 1, cx * 2 + 1, '{');
+      mvwaddch(win, cy + 1, cx * 2 + 2, '}');
+    }
+  }
+}
+
+static void drawFrame(const SpectatorFrame_t *frame) {
+  werase(field_win);
+  werase(info_win);
+  box(field_win, 0, 0);
+  box(info_win, 0, 0);
+  mvwprintw(field_win, 0, 1, " SPECTATOR ");
+  mvwprintw(info_win, 0, 1, " INFO ");
+
+  for (int y = 0; y < FIELD_HEIGHT; y++) {
+    for (int x = 0; x < FIELD_WIDTH; x++) {
+      bool filled = frame->rows[y] & (1u << x);
+      mvwaddch(field_win, y + 1, x * 2 + 1, filled ? '[' : ' ');
+      mvwaddch(field_win, y + 1, x * 2 + 2, filled ? ']' : ' ');
+    }
+  }
+  if (frame->state == GAME_MOVING) {
+    drawPiece(field_win, frame->piece, frame->rotation, frame->x, frame->y,
+              true);
+  }
+
+  mvwprintw(info_win, 2, 2, "NEXT:");
+  if (frame->next >= 0) drawPiece(info_win, frame->next, 0, 0, 3, false);
+  mvwprintw(info_win, 10, 2, "SCORE: %d", frame->score);
+  mvwprintw(info_win, 11, 2, "HIGH: %d", frame->high_score);
+  mvwprintw(info_win, 12, 2, "LEVEL: %d", frame->level);
+  if (frame->pause) mvwprintw(info_win, 14, 2, "PAUSED");
+  if (frame->state == GAME_OVER) mvwprintw(info_win, 14, 2, "GAME OVER");
+  mvwprintw(info_win, 17, 2, "FRAME: %llu",
+            (unsigned long long)frame->number);
+  mvwprintw(info_win, 19, 2, "R - Reconnect");
+  mvwprintw(info_win, 20, 2, "Q - Quit");
+
+  wrefresh(field_win);
+  wrefresh(info_win);
+}
+
+static void drawWaiting(const char *name) {
+  werase(field_win);
+  box(field_win, 0, 0);
+  mvwprintw(field_win, FIELD_HEIGHT / 2, 2, "Waiting for game");
+  mvwprintw(field_win, FIELD_HEIGHT / 2 + 1, 2, "%.18s", name);
+  wrefresh(field_win);
+}
+
+int main(int argc, char **argv) {
+  const char *name = argc > 1 ? argv[1] : SPECTATOR_FEED_NAME;
+
+  initscr();
+  cbreak();
+  noecho();
+  nodelay(stdscr, TRUE);
+  curs_set(0);
+  refresh();
+  field_win = newwin(VIEW_FIELD_HEIGHT, VIEW_FIELD_WIDTH, 1, 1);
+  info_win =
+      newwin(VIEW_FIELD_HEIGHT, VIEW_INFO_WIDTH, 1, VIEW_FIELD_WIDTH + 2);
+
+  const SpectatorFeed_t *feed = NULL;
+  uint64_t shown = 0;
+  bool running = true;
+  for (int polls = 0; running; polls++) {
+    int ch = getch();
+    if (ch == 'q' || ch == 'Q') running = false;
+    if ((ch == 'r' || ch == 'R') && feed) {
+      spectatorDetach(feed);
+      feed = NULL;
+      polls = 0;
+    }
+
+    if (!feed && polls % ATTACH_POLLS == 0) {
+      feed = spectatorAttach(name);
+      shown = 0;
+      if (!feed) drawWaiting(name);
+    }
+
+    // Чтение кадра — только обращения к памяти, без системных вызовов
+    SpectatorFrame_t frame;
+    if (feed && spectatorRead(feed, &frame) && frame.number != shown) {
+      drawFrame(&frame);
+      shown = frame.number;
+    }
+    napms(POLL_MS);
+  }
+
+  spectatorDetach(feed);
+  delwin(field_win);
+  delwin(info_win);
+  endwin();
+  return 0;
+}
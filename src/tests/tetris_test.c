@@ -1,6 +1,18 @@
 #include "tetris.h"
 
 #include <check.h>
+#include <unistd.h>
+
+#include "ai.h"
+#include "arena.h"
+#include "placement.h"
+#include "script.h"
+#include "session.h"
+#include "spectator.h"
+#include "timerwheel.h"
+#include "trace.h"
+#include "vecenv.h"
+#include "versus.h"
 
 START_TEST(test_init_game) {
   initGame();
@@ -223,8 +235,8 @@ START_TEST(test_game_over_condition) {
 
   // Заполняем верхнюю часть поля
   for (int x = 0; x < FIELD_WIDTH; x++) {
-    game.info.field[0][x] = 1;
-    game.info.field[1][x] = 1;
+    setCell(x, 0, 1);
+    setCell(x, 1, 1);
   }
 
   // Пытаемся создать новую фигуру
@@ -250,6 +262,70 @@ START_TEST(test_update_current_state) {
 }
 END_TEST
 
+START_TEST(test_virtual_clock) {
+  VirtualClock_t clock = {1000};
+  setGameClock(virtualClock(&clock));
+  ck_assert_int_eq(gameClockNow(), 1000);
+  virtualClockAdvance(&clock, -5);
+  ck_assert_int_eq(gameClockNow(), 1000);
+
+  // Гравитация идет только вместе с виртуальными часами
+  initGame();
+  updateCurrentState();
+  userInput(Start, false);
+  int y = game.current.y;
+  virtualClockAdvance(&clock, game.info.speed);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y);
+  virtualClockAdvance(&clock, 1);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y + 1);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y + 1);
+
+  setGameClock(monotonicClock());
+  int64_t now = gameClockNow();
+  ck_assert_int_ge(gameClockNow(), now);
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_pause_freezes_gravity) {
+  VirtualClock_t clock = {1000};
+  setGameClock(virtualClock(&clock));
+  initGame();
+  updateCurrentState();
+  userInput(Start, false);
+  int y = game.current.y;
+  virtualClockAdvance(&clock, game.info.speed / 2);
+  updateCurrentState();
+  userInput(Pause, false);
+
+  // Пауза длиннее шага гравитации, без обновлений и с ними
+  virtualClockAdvance(&clock, game.info.speed * 3);
+  userInput(Pause, false);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y);
+  userInput(Pause, false);
+  virtualClockAdvance(&clock, game.info.speed * 3);
+  updateCurrentState();
+  userInput(Start, false);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y);
+
+  // Отсчет продолжается с половины шага, набранной до паузы
+  virtualClockAdvance(&clock, game.info.speed / 2);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y);
+  virtualClockAdvance(&clock, game.info.speed / 2 + 1);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y + 1);
+
+  setGameClock(monotonicClock());
+  freeGame();
+}
+END_TEST
+
 START_TEST(test_place_tetromino) {
   initGame();
 
@@ -271,6 +347,9 @@ START_TEST(test_place_tetromino) {
     }
   }
   ck_assert_int_eq(blocks_placed, 4);  // O-piece состоит из 4 блоков
+  // Клетки помнят тип фигуры и занимают по байту, строки — наибольшей ширины
+  ck_assert_int_eq(CELL_TYPE(game.info.field[18][5]), 1);
+  ck_assert_uint_eq(sizeof(game.cells), FIELD_HEIGHT_MAX * FIELD_WIDTH_MAX);
 
   freeGame();
 }
@@ -281,12 +360,12 @@ START_TEST(test_clear_lines) {
 
   // Заполняем нижнюю линию полностью
   for (int x = 0; x < FIELD_WIDTH; x++) {
-    game.info.field[FIELD_HEIGHT - 1][x] = 1;
+    setCell(x, FIELD_HEIGHT - 1, 1);
   }
 
   // Заполняем предпоследнюю линию частично
   for (int x = 0; x < FIELD_WIDTH - 1; x++) {
-    game.info.field[FIELD_HEIGHT - 2][x] = 1;
+    setCell(x, FIELD_HEIGHT - 2, 1);
   }
 
   int initial_score = game.info.score;
@@ -315,7 +394,7 @@ START_TEST(test_clear_multiple_lines) {
   // Заполняем 3 нижние линии полностью
   for (int y = FIELD_HEIGHT - 3; y < FIELD_HEIGHT; y++) {
     for (int x = 0; x < FIELD_WIDTH; x++) {
-      game.info.field[y][x] = 1;
+      setCell(x, y, 1);
     }
   }
 
@@ -338,8 +417,8 @@ START_TEST(test_can_rotate_blocked) {
   game.current.y = 1;
 
   // Создаем препятствие для поворота
-  game.info.field[1][6] = 1;  // Блокируем справа
-  game.info.field[2][5] = 1;  // Блокируем снизу-справа
+  setCell(6, 1, 1);  // Блокируем справа
+  setCell(5, 2, 1);  // Блокируем снизу-справа
 
   // Пытаемся повернуть - должно быть заблокировано
   bool can_rotate = canRotate(game.current);
@@ -388,12 +467,16 @@ START_TEST(test_drop_tetromino) {
 }
 END_TEST
 
-START_TEST(test_save_load_high_score) {
+START_TEST(test_record_load_high_score) {
+  const char *path = "test_high_score.dat";
+  unlink(path);
+  setLeaderboardFile(path);
   initGame();
+  ck_assert_int_eq(game.info.high_score, 0);
 
-  // Устанавливаем рекорд
-  game.info.high_score = 12345;
-  saveHighScore();
+  // Результат партии попадает в таблицу рекордов
+  game.info.score = 12345;
+  recordGameResult();
 
   // Сбрасываем рекорд
   game.info.high_score = 0;
@@ -405,6 +488,7 @@ START_TEST(test_save_load_high_score) {
   ck_assert_int_eq(game.info.high_score, 12345);
 
   freeGame();
+  unlink(path);
 }
 END_TEST
 
@@ -430,6 +514,1107 @@ START_TEST(test_pause_toggle) {
 }
 END_TEST
 
+START_TEST(test_auto_repeat) {
+  initGame();
+  seedGame(3);
+  resetGame();
+  userInput(Start, false);
+  setAutoRepeat(100, 20);
+  int x = game.current.x;
+
+  // Сдвиг сразу, первый повтор через задержку, дальше через интервал
+  userInput(Left, true);
+  ck_assert_int_eq(game.current.x, x - 1);
+  ck_assert_int_le(engineTimeout(), 100);
+  stepGame(99);
+  ck_assert_int_eq(game.current.x, x - 1);
+  stepGame(1);
+  ck_assert_int_eq(game.current.x, x - 2);
+  stepGame(20);
+  ck_assert_int_eq(game.current.x, x - 3);
+
+  // Повтор клавиатуры поглощается, отпускание не сдвигает
+  userInput(Left, true);
+  ck_assert_int_eq(game.current.x, x - 3);
+  userInput(Left, false);
+  stepGame(100);
+  ck_assert_int_eq(game.current.x, x - 3);
+
+  // У стены повторы ждут, а нажатие в другую сторону сменяет удержание
+  userInput(Left, true);
+  stepGame(1000);
+  ck_assert(!canMove(game.current, -1, 0));
+  int wall = game.current.x;
+  userInput(Right, true);
+  ck_assert_int_eq(game.current.x, wall + 1);
+  stepGame(100);
+  ck_assert_int_eq(game.current.x, wall + 2);
+  userInput(Right, false);
+
+  // Удержание Down опускает фигуру построчно, а не сбрасывает ее
+  int y = game.current.y;
+  userInput(Down, true);
+  ck_assert_int_eq(game.state, GAME_MOVING);
+  ck_assert_int_eq(game.current.y, y + 1);
+  stepGame(20);
+  ck_assert_int_eq(game.current.y, y + 2);
+
+  // Пауза отпускает клавишу
+  userInput(Pause, false);
+  userInput(Pause, false);
+  stepGame(20);
+  ck_assert_int_eq(game.current.y, y + 2);
+
+  setAutoRepeat(ENGINE_REPEAT_DELAY_MS, ENGINE_REPEAT_INTERVAL_MS);
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_restart_reuses_buffers) {
+  initGame();
+  Cell_t (*field)[FIELD_WIDTH_MAX] = game.info.field;
+
+  setCell(0, FIELD_HEIGHT - 1, 1);
+  game.info.score = 700;
+  game.info.high_score = 900;
+  game.info.level = 2;
+  game.state = GAME_OVER;
+
+  userInput(Start, false);
+  ck_assert_int_eq(game.state, GAME_START);
+  ck_assert_ptr_eq(game.info.field, field);
+  ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 1][0], 0);
+  ck_assert_int_eq(game.info.score, 0);
+  ck_assert_int_eq(game.info.level, 1);
+  ck_assert_int_eq(game.info.high_score, 900);  // Рекорд не перечитывается
+
+  freeGame();
+  ck_assert_ptr_null(game.info.field);
+  ck_assert_ptr_null(game.info.next);
+}
+END_TEST
+
+START_TEST(test_next_queue) {
+  initGame();
+  setNextQueueLength(4);
+
+  int expected[5];
+  for (int i = 0; i < 4; i++) {
+    expected[i] = peekNextPiece(i);
+    ck_assert_int_ge(expected[i], 0);
+    ck_assert_int_lt(expected[i], TETROMINO_COUNT);
+  }
+  ck_assert_int_eq(peekNextPiece(4), -1);
+  ck_assert_ptr_eq(game.info.next, getPreview(expected[0]));
+
+  // Каждое появление фигуры сдвигает очередь на одну позицию
+  for (int i = 0; i < 3; i++) {
+    spawnTetromino();
+    ck_assert_int_eq(game.current.type, expected[i]);
+    ck_assert_int_eq(peekNextPiece(0), expected[i + 1]);
+    ck_assert_ptr_eq(game.info.next, getPreview(expected[i + 1]));
+  }
+
+  // Превью совпадает с формой фигуры в начальном повороте
+  int **preview = getPreview(expected[3]);
+  for (int y = 0; y < NEXT_SIZE; y++) {
+    for (int x = 0; x < NEXT_SIZE; x++) {
+      ck_assert_int_eq(preview[y][x], getTetrominoBlock(expected[3], 0, x, y));
+    }
+  }
+
+  setNextQueueLength(1);
+  ck_assert_int_eq(peekNextPiece(0), expected[3]);
+  ck_assert_int_eq(peekNextPiece(1), -1);
+
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_seed_reproducible) {
+  initGame();
+  setNextQueueLength(1);
+
+  int first[20];
+  seedGame(42);
+  resetGame();
+  for (int i = 0; i < 20; i++) {
+    spawnTetromino();
+    first[i] = game.current.type;
+  }
+
+  seedGame(42);
+  resetGame();
+  for (int i = 0; i < 20; i++) {
+    spawnTetromino();
+    ck_assert_int_eq(game.current.type, first[i]);
+  }
+
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_ai_completes_line) {
+  initGame();
+
+  // Нижняя строка заполнена, кроме четырех клеток справа
+  for (int x = 0; x < FIELD_WIDTH - 4; x++) {
+    setCell(x, FIELD_HEIGHT - 1, 1);
+  }
+  game.current.type = 0;  // I-piece
+  game.current.rotation = 0;
+  game.current.x = FIELD_WIDTH / 2 - 2;
+  game.current.y = 0;
+  game.state = GAME_MOVING;
+
+  AiMove_t move;
+  ck_assert(aiFindMove(&ai_default_weights, &move));
+  ck_assert_int_eq(move.rotation, 0);
+  ck_assert_int_eq(move.x, FIELD_WIDTH - 4);
+
+  // Выбор aiFindMove — лучшее из размещений aiListMoves
+  AiMove_t moves[AI_MAX_CANDIDATES];
+  int listed = aiListMoves(&ai_default_weights, moves);
+  ck_assert_int_gt(listed, 0);
+  bool found = false;
+  for (int i = 0; i < listed; i++) {
+    ck_assert(moves[i].score <= move.score);
+    found |= moves[i].rotation == move.rotation && moves[i].x == move.x;
+  }
+  ck_assert(found);
+
+  UserAction_t actions[AI_MAX_ACTIONS];
+  int count = aiPlanActions(move, actions);
+  ck_assert_int_eq(actions[count - 1], Down);
+  for (int i = 0; i < count; i++) {
+    userInput(actions[i], false);
+  }
+  ck_assert_int_eq(game.lines_cleared, 1);
+
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_ai_lookahead) {
+  initGame();
+
+  for (int x = 0; x < FIELD_WIDTH - 4; x++) {
+    setCell(x, FIELD_HEIGHT - 1, 1);
+  }
+  game.current.type = 0;  // I-piece
+  game.current.rotation = 0;
+  game.current.x = FIELD_WIDTH / 2 - 2;
+  game.current.y = 0;
+  game.state = GAME_MOVING;
+  // Следующая фигура влияет на выбор, поэтому не зависит от зерна
+  game.queue[game.queue_head] = 1;  // O-piece
+
+  Arena_t *arena = threadArena();
+  ck_assert_ptr_nonnull(arena);
+  size_t used = arena->used;
+
+  AiMove_t move;
+  ck_assert(aiFindMoveLookahead(&ai_default_weights, &move));
+  ck_assert_int_eq(move.rotation, 0);
+  ck_assert_int_eq(move.x, FIELD_WIDTH - 4);
+  // Поиск возвращает арене всю взятую память
+  ck_assert_uint_eq(arena->used, used);
+  ck_assert_uint_gt(arena->peak, used);
+
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_arena_and_pool) {
+  static uint8_t buffer[1024];
+  Arena_t arena;
+  arenaInitBuffer(&arena, buffer + 1, sizeof(buffer) - 1);
+
+  void *a = arenaAlloc(&arena, 3);
+  ck_assert_ptr_nonnull(a);
+  ck_assert_uint_eq((uintptr_t)a % ARENA_ALIGN, 0);
+  size_t mark = arenaMark(&arena);
+  void *b = arenaAlloc(&arena, 100);
+  ck_assert_uint_eq((uintptr_t)b % ARENA_ALIGN, 0);
+  ck_assert_ptr_null(arenaAlloc(&arena, sizeof(buffer)));
+
+  // Освобождение до отметки возвращает тот же адрес
+  arenaRelease(&arena, mark);
+  ck_assert_ptr_eq(arenaAlloc(&arena, 100), b);
+  arenaReset(&arena);
+  ck_assert_ptr_eq(arenaAlloc(&arena, 3), a);
+
+  Arena_t heap;
+  ck_assert(arenaInit(&heap, 4 * (sizeof(BoardSnapshot_t) + ARENA_ALIGN)));
+  Pool_t pool;
+  ck_assert(boardPoolInit(&pool, &heap, 4));
+  BoardSnapshot_t *snapshots[4];
+  for (int i = 0; i < 4; i++) {
+    snapshots[i] = poolAlloc(&pool);
+    ck_assert_ptr_nonnull(snapshots[i]);
+  }
+  ck_assert_ptr_null(poolAlloc(&pool));
+  poolFree(&pool, snapshots[2]);
+  ck_assert_int_eq(pool.used, 3);
+  ck_assert_ptr_eq(poolAlloc(&pool), snapshots[2]);
+
+  initGame();
+  setCell(3, FIELD_HEIGHT - 1, 1);
+  captureBoard(snapshots[0]);
+  setCell(3, FIELD_HEIGHT - 1, 0);
+  restoreBoard(snapshots[0]);
+  ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 1][3], 1);
+  freeGame();
+
+  arenaFree(&heap);
+}
+END_TEST
+
+START_TEST(test_eval_features) {
+  Bitboard_t board = {{0}};
+  // Столбец 0 высотой 4, столбец 2 высотой 2 с дырой под ним в столбце 3,
+  // нижняя строка заполнена, кроме столбца 3
+  board.rows[FIELD_HEIGHT - 4] = 0x001;
+  board.rows[FIELD_HEIGHT - 3] = 0x001;
+  board.rows[FIELD_HEIGHT - 2] = 0x00d;
+  board.rows[FIELD_HEIGHT - 1] = BITBOARD_FULL_ROW & ~0x008;
+
+  BoardFeatures_t f;
+  evaluateBoardsScalar(&board, 1, &f);
+  // Высоты столбцов: 4 1 2 2 1 1 1 1 1 1
+  ck_assert_int_eq(f.values[FEATURE_AGGREGATE_HEIGHT], 15);
+  ck_assert_int_eq(f.values[FEATURE_MAX_HEIGHT], 4);
+  ck_assert_int_eq(f.values[FEATURE_HOLES], 1);
+  ck_assert_int_eq(f.values[FEATURE_BUMPINESS], 3 + 1 + 0 + 1);
+  ck_assert_int_eq(f.values[FEATURE_COMPLETE_LINES], 0);
+  ck_assert_int_eq(f.values[FEATURE_WELL_CELLS], 1);  // Клетка (1, 18)
+  ck_assert_int_eq(f.values[FEATURE_COLUMN_TRANSITIONS], 12);
+}
+END_TEST
+
+START_TEST(test_eval_simd_matches_scalar) {
+  enum { COUNT = 29 };  // 16 (AVX2) + 8 (SSE2) + 5 (скалярный остаток)
+  static Bitboard_t boards[COUNT];
+  BoardFeatures_t fast[COUNT], reference[COUNT];
+
+  uint32_t x = 12345;
+  for (int i = 0; i < COUNT; i++) {
+    for (int y = 0; y < FIELD_HEIGHT; y++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      // Верхние строки оставляем пустыми, ниже — случайное заполнение
+      boards[i].rows[y] = y > i % FIELD_HEIGHT ? x & BITBOARD_FULL_ROW : 0;
+    }
+  }
+  boards[3].rows[FIELD_HEIGHT - 1] = BITBOARD_FULL_ROW;
+
+  evaluateBoards(boards, COUNT, fast);
+  evaluateBoardsScalar(boards, COUNT, reference);
+  for (int i = 0; i < COUNT; i++) {
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+      ck_assert_int_eq(fast[i].values[f], reference[i].values[f]);
+    }
+  }
+}
+END_TEST
+
+START_TEST(test_leaderboard_sorted_insert) {
+  const char *path = "test_leaderboard.dat";
+  unlink(path);
+
+  LeaderboardEntry_t entry = {0};
+  strcpy(entry.player, "alice");
+  int scores[] = {300, 1500, 700, 700};
+  for (int i = 0; i < 4; i++) {
+    entry.score = scores[i];
+    entry.lines = i;
+    ck_assert_int_ge(leaderboardInsert(path, &entry), 0);
+  }
+
+  LeaderboardEntry_t entries[8];
+  ck_assert_int_eq(leaderboardRead(path, entries, 8), 4);
+  ck_assert_int_eq(entries[0].score, 1500);
+  ck_assert_int_eq(entries[1].score, 700);
+  ck_assert_int_eq(entries[1].lines, 2);  // Равные счета — в порядке вставки
+  ck_assert_int_eq(entries[2].lines, 3);
+  ck_assert_int_eq(entries[3].score, 300);
+  ck_assert_int_eq(leaderboardBest(path), 1500);
+
+  unlink(path);
+}
+END_TEST
+
+START_TEST(test_leaderboard_per_player_limit) {
+  const char *path = "test_leaderboard.dat";
+  unlink(path);
+
+  LeaderboardEntry_t entry = {0};
+  strcpy(entry.player, "bob");
+  for (int i = 1; i <= LEADERBOARD_PER_PLAYER; i++) {
+    entry.score = i * 100;
+    leaderboardInsert(path, &entry);
+  }
+  entry.score = 50;  // Хуже всех результатов игрока
+  ck_assert_int_eq(leaderboardInsert(path, &entry), -1);
+  entry.score = 5000;  // Вытесняет худший результат игрока
+  ck_assert_int_eq(leaderboardInsert(path, &entry), 0);
+
+  strcpy(entry.player, "carol");
+  entry.score = 10;
+  ck_assert_int_eq(leaderboardInsert(path, &entry), LEADERBOARD_PER_PLAYER);
+
+  LeaderboardEntry_t entries[LEADERBOARD_PER_PLAYER + 2];
+  int n = leaderboardRead(path, entries, LEADERBOARD_PER_PLAYER + 2);
+  ck_assert_int_eq(n, LEADERBOARD_PER_PLAYER + 1);
+  ck_assert_int_eq(entries[LEADERBOARD_PER_PLAYER - 1].score, 200);
+
+  unlink(path);
+}
+END_TEST
+
+#ifdef TETRIS_EVENTS
+START_TEST(test_events_line_clear) {
+  initGame();
+  GameEvent_t events[16];
+  pollGameEvents(events, 16);
+
+  for (int x = 0; x < FIELD_WIDTH; x++) {
+    setCell(x, FIELD_HEIGHT - 1, 1);
+    setCell(x, FIELD_HEIGHT - 3, 1);
+  }
+  clearLines();
+
+  int n = pollGameEvents(events, 16);
+  ck_assert_int_eq(n, 1);
+  ck_assert_int_eq(events[0].type, EVENT_LINE_CLEAR);
+  ck_assert_int_eq(events[0].count, 2);
+  ck_assert_int_eq(events[0].rows[0], FIELD_HEIGHT - 1);
+  ck_assert_int_eq(events[0].rows[1], FIELD_HEIGHT - 3);
+  ck_assert_int_eq(events[0].score, 300);
+
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_events_spawn_and_move) {
+  initGame();
+  GameEvent_t events[16];
+  pollGameEvents(events, 16);
+
+  spawnTetromino();
+  moveTetromino(-1, 0);
+
+  int n = pollGameEvents(events, 16);
+  ck_assert_int_eq(n, 2);
+  ck_assert_int_eq(events[0].type, EVENT_SPAWN);
+  ck_assert_int_eq(events[1].type, EVENT_MOVE);
+  ck_assert_int_eq(events[1].x, FIELD_WIDTH / 2 - 3);
+  ck_assert_int_eq(pollGameEvents(events, 16), 0);
+
+  freeGame();
+}
+END_TEST
+#endif
+
+START_TEST(test_engine_interface) {
+  engineInit();
+  engineNewGame(7);
+  const EngineInfo_t *info = engineInfo();
+  ck_assert_str_eq(info->title, "TETRIS");
+  ck_assert_int_eq(info->cell_kinds, TETROMINO_COUNT + 1);
+  ck_assert_int_le(info->cell_kinds, ENGINE_CELL_KINDS_MAX);
+  ck_assert_int_eq(engineState(), ENGINE_START);
+  ck_assert_int_eq(engineTimeout(), -1);
+
+  EngineCell_t cells[ENGINE_ACTIVE_MAX];
+  ck_assert_int_eq(engineActiveCells(cells), 0);
+  uint64_t version = engineVersion();
+  userInput(Start, false);
+  ck_assert_int_eq(engineState(), ENGINE_PLAYING);
+  ck_assert_uint_gt(engineVersion(), version);
+  ck_assert_int_eq(engineActiveCells(cells), 4);
+  for (int i = 0; i < 4; i++) {
+    ck_assert_int_eq(cells[i].cell, CELL_PIECE(game.current.type));
+  }
+
+  // Через engineTimeout мс фигура сдвигается сама, раньше — нет
+  int64_t timeout = engineTimeout();
+  ck_assert_int_gt(timeout, 0);
+  int y = game.current.y;
+  version = engineVersion();
+  engineStep((int)timeout - 1);
+  ck_assert_int_eq(game.current.y, y);
+  ck_assert_uint_eq(engineVersion(), version);
+  engineStep(1);
+  ck_assert_int_eq(game.current.y, y + 1);
+  ck_assert_uint_gt(engineVersion(), version);
+
+  static _Alignas(max_align_t) unsigned char snapshot[sizeof(Game_t)];
+  ck_assert_uint_le(engineSnapshotSize(), sizeof(snapshot));
+  engineSave(snapshot);
+  userInput(Pause, false);
+  ck_assert_int_eq(engineState(), ENGINE_PAUSED);
+  engineLoad(snapshot);
+  ck_assert_int_eq(engineState(), ENGINE_PLAYING);
+
+  char status[ENGINE_STATUS_SIZE];
+  ck_assert_int_gt(engineStatus(status, sizeof(status)), 0);
+  ck_assert_ptr_nonnull(strstr(status, "score 0"));
+
+  userInput(Terminate, false);
+  ck_assert_int_eq(engineState(), ENGINE_EXIT);
+  engineFree();
+}
+END_TEST
+
+static int script_hook_calls;
+
+static void countScriptTick(GameInfo_t info) {
+  ck_assert_ptr_nonnull(info.field);
+  script_hook_calls++;
+}
+
+START_TEST(test_script_actions) {
+  initGame();
+  ScriptStats_t stats = {0};
+  const char start[] = "s.";
+  scriptApply(start, sizeof(start) - 1, stdout, &stats);
+  ck_assert_int_eq(game.state, GAME_MOVING);
+  int x = game.current.x;
+
+  // Все действия пакета применяются до следующего тика
+  const char moves[] = "l l\nl x.";
+  scriptApply(moves, sizeof(moves) - 1, stdout, &stats);
+  ck_assert_int_eq(game.current.x, x - 3);
+  ck_assert_int_eq(stats.actions, 4);
+  ck_assert_int_eq(stats.ticks, 2);
+  ck_assert_int_eq(stats.invalid, 1);
+
+  // Функция тика вызывается после каждого '.'
+  setScriptTickHook(countScriptTick);
+  scriptApply("..", 2, stdout, &stats);
+  setScriptTickHook(NULL);
+  ck_assert_int_eq(script_hook_calls, 2);
+  ck_assert_int_eq(stats.ticks, 4);
+
+  int fds[2];
+  ck_assert_int_eq(pipe(fds), 0);
+  const char stream[] = "d.d.d.";
+  ck_assert_int_eq(write(fds[1], stream, sizeof(stream) - 1),
+                   (int)sizeof(stream) - 1);
+  close(fds[1]);
+  ck_assert_int_eq(runScript(fds[0], &stats), 0);
+  close(fds[0]);
+  ck_assert_int_eq(stats.actions, 7);
+  ck_assert_int_eq(game.state, GAME_EXIT);
+
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_vecenv_step) {
+  enum { COUNT = 8, STEPS = 400 };
+  initGame();
+  GameState_t state = game.state;
+
+  VecEnv_t single, parallel;
+  ck_assert(vecEnvInit(&single, COUNT, FIELD_WIDTH, FIELD_HEIGHT, 1, 7));
+  ck_assert(vecEnvInit(&parallel, COUNT, FIELD_WIDTH, FIELD_HEIGHT, 3, 7));
+
+  static Cell_t boards[2][COUNT][FIELD_HEIGHT][FIELD_WIDTH];
+  static uint16_t rows[2][COUNT][FIELD_HEIGHT];
+  static int8_t pieces[2][COUNT][VECENV_PIECE_FIELDS];
+  static int32_t rewards[2][COUNT];
+  static uint8_t dones[2][COUNT];
+  VecEnvObs_t obs[2];
+  for (int k = 0; k < 2; k++) {
+    obs[k] = (VecEnvObs_t){&boards[k][0][0][0], &rows[k][0][0],
+                           &pieces[k][0][0], rewards[k], dones[k]};
+  }
+
+  int8_t actions[COUNT];
+  long done_count = 0;
+  for (int step = 0; step < STEPS; step++) {
+    for (int i = 0; i < COUNT; i++) {
+      static const int8_t choices[] = {VECENV_NOOP, Left, Right, Action, Down};
+      actions[i] = choices[(step * 7 + i * 3) % 5];
+    }
+    vecEnvStep(&single, actions, &obs[0]);
+    vecEnvStep(&parallel, actions, &obs[1]);
+
+    // Результат не зависит от числа потоков
+    ck_assert_mem_eq(boards[0], boards[1], sizeof(boards[0]));
+    ck_assert_mem_eq(pieces[0], pieces[1], sizeof(pieces[0]));
+    ck_assert_mem_eq(rewards[0], rewards[1], sizeof(rewards[0]));
+    ck_assert_mem_eq(dones[0], dones[1], sizeof(dones[0]));
+    for (int i = 0; i < COUNT; i++) done_count += dones[0][i];
+  }
+
+  // Битовые строки совпадают с клетками
+  for (int i = 0; i < COUNT; i++) {
+    for (int y = 0; y < FIELD_HEIGHT; y++) {
+      for (int x = 0; x < FIELD_WIDTH; x++) {
+        ck_assert_int_eq((rows[1][i][y] >> x) & 1,
+                         boards[1][i][y][x] != CELL_EMPTY);
+      }
+    }
+  }
+  // Жесткие сбросы быстро заканчивают игры, и они начинаются заново
+  ck_assert_int_gt(done_count, 0);
+  ck_assert_int_eq(game.state, state);
+
+  vecEnvFree(&single);
+  vecEnvFree(&parallel);
+
+  // Узкое поле для обучения: наблюдения по его размеру
+  enum { NARROW_W = 4, NARROW_H = 8 };
+  VecEnv_t narrow;
+  ck_assert(!vecEnvInit(&narrow, 2, VECENV_WIDTH_MAX + 1, 8, 1, 1));
+  ck_assert(vecEnvInit(&narrow, 2, NARROW_W, NARROW_H, 2, 1));
+  static Cell_t narrow_boards[2][NARROW_H][NARROW_W];
+  static uint16_t narrow_rows[2][NARROW_H];
+  long filled = 0;
+  VecEnvObs_t narrow_obs = {.boards = &narrow_boards[0][0][0],
+                            .rows = &narrow_rows[0][0]};
+  for (int step = 0; step < 100; step++) {
+    int8_t drops[2] = {Down, step % 2 ? Left : Down};
+    vecEnvStep(&narrow, drops, &narrow_obs);
+    for (int i = 0; i < 2; i++) {
+      for (int y = 0; y < NARROW_H; y++) {
+        for (int x = 0; x < NARROW_W; x++) {
+          ck_assert_int_eq((narrow_rows[i][y] >> x) & 1,
+                           narrow_boards[i][y][x] != CELL_EMPTY);
+        }
+        ck_assert_uint_lt(narrow_rows[i][y], 1u << NARROW_W);
+        filled += narrow_rows[i][y] != 0;
+      }
+    }
+  }
+  ck_assert_int_gt(filled, 0);
+  vecEnvFree(&narrow);
+  freeGame();
+}
+END_TEST
+
+typedef struct {
+  TimerNode_t node;
+  uint64_t fired_at;
+  int fired;
+} TestTimer_t;
+
+static void fireTestTimer(TimerNode_t *node, void *context) {
+  TestTimer_t *timer = (TestTimer_t *)node;
+  timer->fired_at = *(const uint64_t *)context;
+  timer->fired++;
+}
+
+START_TEST(test_timer_wheel) {
+  enum { COUNT = 200 };
+  static TimerWheel_t wheel;
+  static TestTimer_t timers[COUNT];
+  memset(timers, 0, sizeof(timers));
+  timerWheelInit(&wheel, 1000);
+  ck_assert_int_eq(timerWheelTimeout(&wheel), -1);
+
+  // Сроки на всех уровнях колеса, включая дальше одного оборота
+  uint32_t x = 1;
+  for (int i = 0; i < COUNT; i++) {
+    x = x * 1103515245u + 12345u;
+    uint64_t delay = i % 4 == 0 ? x % 64 : i % 4 == 1 ? x % 4096 : x % 300000;
+    timerWheelAdd(&wheel, &timers[i].node, 1000 + 1 + delay);
+  }
+  timerWheelCancel(&wheel, &timers[7].node);
+  timerWheelAdd(&wheel, &timers[8].node, 1500);  // Перестановка
+
+  uint64_t now = 1000;
+  while (timerWheelTimeout(&wheel) >= 0) {
+    // Оценка ожидания не позже ближайшего срока
+    uint64_t earliest = UINT64_MAX;
+    for (int i = 0; i < COUNT; i++) {
+      if (timers[i].node.active && timers[i].node.expires < earliest) {
+        earliest = timers[i].node.expires;
+      }
+    }
+    int64_t timeout = timerWheelTimeout(&wheel);
+    ck_assert_uint_le(now + (uint64_t)timeout, earliest);
+    now += timeout > 0 ? (uint64_t)timeout : 1;
+    timerWheelAdvance(&wheel, now, fireTestTimer, &now);
+  }
+
+  for (int i = 0; i < COUNT; i++) {
+    ck_assert_int_eq(timers[i].fired, i == 7 ? 0 : 1);
+    if (i != 7) ck_assert_uint_eq(timers[i].fired_at, timers[i].node.expires);
+  }
+  ck_assert_uint_eq(timers[8].fired_at, 1500);
+}
+END_TEST
+
+START_TEST(test_garbage_lines) {
+  initGame();
+  userInput(Start, false);
+  setCell(0, FIELD_HEIGHT - 1, CELL_PIECE(2));
+  int y = game.current.y;
+
+  addGarbage(2, 3);
+  ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 3][0], CELL_PIECE(2));
+  for (int x = 0; x < FIELD_WIDTH; x++) {
+    int expected = x == 3 ? CELL_EMPTY : CELL_GARBAGE;
+    ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 1][x], expected);
+    ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 2][x], expected);
+  }
+  ck_assert_int_eq(game.current.y, y);
+  ck_assert_int_eq(game.state, GAME_MOVING);
+  ck_assert_int_eq(garbageForLines(4), 4);
+
+  // Вытесненные за верх поля блоки заканчивают игру
+  setCell(0, 1, CELL_PIECE(0));
+  addGarbage(2, 0);
+  ck_assert_int_eq(game.state, GAME_OVER);
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_snapshot_step) {
+  initGame();
+  seedGame(7);
+  resetGame();
+  userInput(Start, false);
+
+  GameSnapshot_t snapshot;
+  saveSnapshot(&snapshot);
+  for (int t = 0; t < 200; t++) {
+    if (t % 20 == 0) userInput(Down, false);
+    stepGame(16);
+  }
+  Game_t first = game;
+
+  // Повтор с того же снимка дает то же состояние
+  loadSnapshot(&snapshot);
+  for (int t = 0; t < 200; t++) {
+    if (t % 20 == 0) userInput(Down, false);
+    stepGame(16);
+  }
+  ck_assert_int_eq(memcmp(game.cells, first.cells, sizeof(game.cells)), 0);
+  ck_assert_int_eq(game.current.type, first.current.type);
+  ck_assert_int_eq(game.current.y, first.current.y);
+  ck_assert_int_eq(game.rng_state, first.rng_state);
+  ck_assert_ptr_eq(game.info.field, game.cells);
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_session_encode) {
+  initGame();
+  seedGame(7);
+  resetGame();
+  userInput(Start, false);
+  for (int t = 0; t < 300; t++) {
+    if (t % 20 == 0) userInput(Down, false);
+    stepGame(16);
+  }
+  addGarbage(2, 3);
+
+  uint8_t packed[ENGINE_ENCODED_MAX];
+  size_t size = engineEncode(packed, sizeof(packed));
+  ck_assert_uint_gt(size, FIELD_WIDTH * FIELD_HEIGHT / 8);
+  ck_assert_uint_lt(size, sizeof(Game_t) / 2);
+  ck_assert_uint_eq(engineEncode(packed, size - 1), 0);
+  Game_t first = game;
+
+  // Распакованная игра продолжается так же, как исходная
+  resetGame();
+  ck_assert(engineDecode(packed, size));
+  ck_assert_int_eq(memcmp(game.cells, first.cells, sizeof(game.cells)), 0);
+  ck_assert_int_eq(game.info.score, first.info.score);
+  for (int t = 0; t < 100; t++) {
+    stepGame(16);
+    Game_t decoded = game;
+    game = first;
+    stepGame(16);
+    first = game;
+    game = decoded;
+    ck_assert_int_eq(game.current.y, first.current.y);
+    ck_assert_int_eq(game.rng_state, first.rng_state);
+  }
+
+  // Поврежденные данные отвергаются, игра не меняется
+  engineEncode(packed, sizeof(packed));
+  packed[size - 1] ^= 0x80;
+  ck_assert(!engineDecode(packed, size));
+  ck_assert(!engineDecode(packed, size - 1));
+  ck_assert_int_eq(game.rng_state, first.rng_state);
+
+  // Файл сохранения
+  const char *path = "test_session.dat";
+  ck_assert(saveSession(path));
+  resetGame();
+  ck_assert(loadSession(path));
+  ck_assert_int_eq(memcmp(game.cells, first.cells, sizeof(game.cells)), 0);
+  FILE *file = fopen(path, "r+b");
+  ck_assert_ptr_nonnull(file);
+  fseek(file, (long)sizeof(SessionHeader_t), SEEK_SET);
+  fputc(0xFF, file);
+  fclose(file);
+  ck_assert(!loadSession(path));
+  removeSession(path);
+  ck_assert(!loadSession(path));
+
+  // Выход с сохранением не записывает незаконченную партию в рекорды
+  const char *leaderboard = "test_leaderboard.dat";
+  unlink(leaderboard);
+  setLeaderboardFile(leaderboard);
+  game.info.score = 500;
+  engineSuspend();
+  ck_assert_int_eq(engineState(), ENGINE_EXIT);
+  userInput(Terminate, false);
+  ck_assert_int_eq(leaderboardBest(leaderboard), 0);
+  unlink(leaderboard);
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_session_resume) {
+  VirtualClock_t clock = {5000};
+  setGameClock(virtualClock(&clock));
+  initGame();
+  updateCurrentState();
+  userInput(Start, false);
+  virtualClockAdvance(&clock, 100);
+  updateCurrentState();
+  int y = game.current.y;
+  uint8_t moving[ENGINE_ENCODED_MAX], paused[ENGINE_ENCODED_MAX];
+  size_t moving_size = engineEncode(moving, sizeof(moving));
+  userInput(Pause, false);
+  size_t paused_size = engineEncode(paused, sizeof(paused));
+
+  // Как при запуске: новая партия с нулевым временем, затем загрузка.
+  // До шага гравитации остается speed - 100 мс от первого обновления
+  virtualClockAdvance(&clock, 10000);
+  engineNewGame(1);
+  ck_assert(engineDecode(moving, moving_size));
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y);
+  virtualClockAdvance(&clock, game.info.speed - 100);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y);
+  virtualClockAdvance(&clock, 1);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y + 1);
+
+  // Сохраненная на паузе партия ждет снятия паузы
+  engineNewGame(1);
+  ck_assert(engineDecode(paused, paused_size));
+  updateCurrentState();
+  virtualClockAdvance(&clock, 10000);
+  updateCurrentState();
+  userInput(Pause, false);
+  updateCurrentState();
+  virtualClockAdvance(&clock, game.info.speed - 100);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y);
+  virtualClockAdvance(&clock, 1);
+  updateCurrentState();
+  ck_assert_int_eq(game.current.y, y + 1);
+
+  setGameClock(monotonicClock());
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_board_sizes) {
+  initGame();
+  ck_assert(!setFieldSize(FIELD_SIZE_MIN - 1, FIELD_HEIGHT));
+  ck_assert(!setFieldSize(FIELD_WIDTH_MAX + 1, FIELD_HEIGHT));
+  ck_assert(!setFieldSize(FIELD_WIDTH, FIELD_HEIGHT_MAX + 1));
+  ck_assert_int_eq(game.info.width, FIELD_WIDTH);
+
+  // По размеру на каждое ядро: 16-, 32- и 64-битные строки
+  const int sizes[][2] = {
+      {7, 9}, {40, 25}, {FIELD_WIDTH_MAX, FIELD_HEIGHT_MAX}};
+  for (int i = 0; i < 3; i++) {
+    int width = sizes[i][0], height = sizes[i][1];
+    ck_assert(engineResize(width, height));
+    ck_assert_int_eq(game.info.width, width);
+    ck_assert_int_eq(game.info.height, height);
+
+    // O у правого края: дальше вправо нельзя, влево можно
+    Tetromino_t piece = {width - 3, height - 3, 1, 0};
+    ck_assert(!canMove(piece, 1, 0));
+    ck_assert(canMove(piece, -1, 0));
+    ck_assert(!canMove(piece, 0, 1));
+
+    // Две нижние строки без правых столбцов дополняет O
+    for (int x = 0; x < width - 2; x++) {
+      setCell(x, height - 1, CELL_PIECE(0));
+      setCell(x, height - 2, CELL_PIECE(0));
+    }
+    setCell(0, height - 3, CELL_PIECE(2));
+    placeTetromino(piece);
+    ck_assert_int_eq(game.info.field[height - 1][width - 1], CELL_PIECE(1));
+    clearLines();
+    ck_assert_int_eq(game.lines_cleared, 2);
+    ck_assert_int_eq(game.info.field[height - 1][0], CELL_PIECE(2));
+    ck_assert_int_eq(game.info.field[height - 1][1], CELL_EMPTY);
+    ck_assert(canMove(piece, 0, 0));
+
+    // Упакованная игра помнит свой размер
+    uint8_t packed[ENGINE_ENCODED_MAX];
+    size_t size = engineEncode(packed, sizeof(packed));
+    ck_assert_uint_gt(size, 0);
+    Game_t first = game;
+    ck_assert(engineResize(FIELD_WIDTH, FIELD_HEIGHT));
+    ck_assert(engineDecode(packed, size));
+    ck_assert_int_eq(game.info.width, width);
+    ck_assert_int_eq(memcmp(game.cells, first.cells, sizeof(game.cells)), 0);
+    ck_assert_int_eq(memcmp(&game.rows, &first.rows, sizeof(game.rows)), 0);
+  }
+
+  ck_assert(setFieldSize(FIELD_WIDTH, FIELD_HEIGHT));
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_place_piece) {
+  initGame();
+  seedGame(5);
+  resetGame();
+  userInput(Start, false);
+
+  // O в правый угол дополняет две нижние строки
+  for (int x = 0; x < FIELD_WIDTH - 2; x++) {
+    setCell(x, FIELD_HEIGHT - 1, CELL_GARBAGE);
+    setCell(x, FIELD_HEIGHT - 2, CELL_GARBAGE);
+  }
+  game.current = (Tetromino_t){3, 0, 1, 0};
+  PlaceResult_t result;
+  ck_assert(placePiece(0, FIELD_WIDTH - 3, &result));
+  ck_assert_int_eq(result.lines, 2);
+  ck_assert_int_eq(result.score, 300);
+  ck_assert_int_eq(result.rows[0], FIELD_HEIGHT - 1);
+  ck_assert_int_eq(result.rows[1], FIELD_HEIGHT - 2);
+  ck_assert_int_eq(result.piece.y, FIELD_HEIGHT - 3);
+  ck_assert_int_eq(game.state, GAME_MOVING);
+  ck_assert_int_eq(game.current.y, 0);
+  ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 1][0], CELL_EMPTY);
+
+  // Поворот на месте появления упирается в блок: путь находит поиск
+  setCell(5, 3, CELL_GARBAGE);
+  game.current = (Tetromino_t){3, 0, 0, 0};
+  ck_assert(!canRotate(game.current));
+  ck_assert(placePiece(1, 0, &result));
+  ck_assert_int_eq(result.piece.x, 0);
+  ck_assert_int_eq(result.piece.y, FIELD_HEIGHT - 4);
+  ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 1][2], CELL_PIECE(0));
+
+  // За стеной во всю высоту столбец недостижим, игра не меняется
+  resetGame();
+  userInput(Start, false);
+  for (int y = 0; y < FIELD_HEIGHT; y++) setCell(8, y, CELL_GARBAGE);
+  game.current = (Tetromino_t){3, 0, 0, 0};
+  uint64_t version = game.version;
+  ck_assert(!placePiece(1, 7, &result));
+  ck_assert(!placePiece(4, 0, &result));
+  ck_assert_int_eq(game.version, version);
+
+  // Путь подсекает O под навес, недопустимый шаг отвергается
+  resetGame();
+  userInput(Start, false);
+  for (int x = 0; x < 6; x++) setCell(x, FIELD_HEIGHT - 3, CELL_GARBAGE);
+  game.current = (Tetromino_t){3, 0, 1, 0};
+  UserAction_t path[32];
+  int count = 0;
+  for (int i = 0; i < 3; i++) path[count++] = Right;
+  for (int i = 0; i < FIELD_HEIGHT - 3; i++) path[count++] = Down;
+  for (int i = 0; i < 7; i++) path[count++] = Left;
+  path[count] = Left;
+  ck_assert(!placePath(path, count + 1, NULL));
+  ck_assert(placePath(path, count, &result));
+  ck_assert_int_eq(result.piece.x, -1);
+  ck_assert_int_eq(result.piece.y, FIELD_HEIGHT - 3);
+  ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 1][0], CELL_PIECE(1));
+  ck_assert_int_eq(game.info.field[FIELD_HEIGHT - 4][0], CELL_EMPTY);
+
+  freeGame();
+}
+END_TEST
+
+START_TEST(test_versus_rollback) {
+  static VersusSession_t on_time, delayed;
+  versusInit(&on_time, 11, 22);
+  versusInit(&delayed, 11, 22);
+
+  enum { TICKS = 600, DELAY = 8 };
+  VersusInput_t local[TICKS], remote[TICKS];
+  uint32_t rng = 12345;
+  for (int t = 0; t < TICKS; t++) {
+    rng = rng * 1103515245u + 12345u;
+    int roll = (int)((rng >> 16) % 16);
+    local[t] = roll < 3 ? (VersusInput_t)(1u << (Left + roll)) : 0;
+    remote[t] = roll > 12 ? (VersusInput_t)(1u << (Action - roll + 13)) : 0;
+    if (t % 25 == 0) remote[t] |= 1u << Down;
+  }
+
+  for (int t = 0; t < TICKS; t++) {
+    ck_assert(versusRemoteInput(&on_time, t, remote[t]));
+    ck_assert(versusAdvance(&on_time, local[t]));
+
+    ck_assert(versusAdvance(&delayed, local[t]));
+    if (t >= DELAY) {
+      ck_assert(versusRemoteInput(&delayed, t - DELAY, remote[t - DELAY]));
+    }
+  }
+  for (int t = TICKS - DELAY; t < TICKS; t++) {
+    ck_assert(versusRemoteInput(&delayed, t, remote[t]));
+  }
+  ck_assert(!versusRemoteInput(&delayed, TICKS + 5, 0));
+
+  ck_assert_int_eq(on_time.rollbacks, 0);
+  ck_assert_int_gt(delayed.rollbacks, 0);
+  for (int p = 0; p < 2; p++) {
+    const Game_t *a = &on_time.games[p], *b = &delayed.games[p];
+    ck_assert_int_eq(memcmp(a->cells, b->cells, sizeof(a->cells)), 0);
+    ck_assert_int_eq(a->info.score, b->info.score);
+    ck_assert_int_eq(a->state, b->state);
+    ck_assert_int_eq(a->current.x, b->current.x);
+    ck_assert_int_eq(a->current.y, b->current.y);
+  }
+  ck_assert_int_eq(versusWinner(&on_time), versusWinner(&delayed));
+}
+END_TEST
+
+START_TEST(test_versus_peers) {
+  // Стороны видят одну партию с переставленными игроками
+  static VersusSession_t a, b;
+  versusInit(&a, 11, 22);
+  versusInit(&b, 22, 11);
+
+  uint32_t rng = 777;
+  for (int t = 0; t < 400; t++) {
+    rng = rng * 1103515245u + 12345u;
+    int roll = (int)((rng >> 16) % 16);
+    VersusInput_t first = roll < 4 ? (VersusInput_t)(1u << (Left + roll)) : 0;
+    VersusInput_t second = roll > 11 ? (VersusInput_t)(1u << (roll - 12)) : 0;
+    // Мусор обоим игрокам, будто каждый очистил линии в этом тике
+    if (t % 6 == 0) {
+      a.games[VERSUS_LOCAL].garbage_out = b.games[VERSUS_REMOTE].garbage_out =
+          1;
+      a.games[VERSUS_REMOTE].garbage_out = b.games[VERSUS_LOCAL].garbage_out =
+          t % 12 == 0 ? 2 : 0;
+    }
+    ck_assert(versusRemoteInput(&a, t, second));
+    ck_assert(versusAdvance(&a, first));
+    ck_assert(versusRemoteInput(&b, t, first));
+    ck_assert(versusAdvance(&b, second));
+  }
+
+  for (int p = 0; p < 2; p++) {
+    const Game_t *x = &a.games[p], *y = &b.games[1 - p];
+    ck_assert_int_eq(memcmp(x->cells, y->cells, sizeof(x->cells)), 0);
+    ck_assert_int_eq(x->info.score, y->info.score);
+    ck_assert_int_eq(x->state, y->state);
+  }
+}
+END_TEST
+
+START_TEST(test_spectator_feed) {
+  char name[64];
+  snprintf(name, sizeof(name), "/tetris-test-%d", (int)getpid());
+  ck_assert(spectatorOpen(name));
+  const SpectatorFeed_t *feed = spectatorAttach(name);
+  ck_assert_ptr_nonnull(feed);
+
+  SpectatorFrame_t frame;
+  ck_assert(!spectatorRead(feed, &frame));
+
+  initGame();
+  setCell(0, FIELD_HEIGHT - 1, 1);
+  setCell(9, FIELD_HEIGHT - 1, 1);
+  userInput(Start, false);
+  spectatorPublish();
+  ck_assert(spectatorRead(feed, &frame));
+  ck_assert_uint_eq(frame.number, 1);
+  ck_assert_uint_eq(frame.rows[FIELD_HEIGHT - 1], 0x201);
+  ck_assert_int_eq(frame.piece, game.current.type);
+  ck_assert_int_eq(frame.next, peekNextPiece(0));
+  ck_assert_int_eq(frame.state, GAME_MOVING);
+
+  // Неизменившееся состояние не публикуется повторно
+  spectatorPublish();
+  ck_assert(spectatorRead(feed, &frame));
+  ck_assert_uint_eq(frame.number, 1);
+
+  userInput(Left, false);
+  ck_assert(spectatorPublish());
+  ck_assert(spectatorRead(feed, &frame));
+  ck_assert_uint_eq(frame.number, 2);
+  ck_assert_int_eq(frame.x, game.current.x);
+
+  // Поле другого размера не публикуется, и об этом сообщается
+  ck_assert(setFieldSize(7, 9));
+  ck_assert(!spectatorPublish());
+  ck_assert(spectatorRead(feed, &frame));
+  ck_assert_uint_eq(frame.number, 2);
+
+  freeGame();
+  spectatorDetach(feed);
+  spectatorClose();
+  ck_assert_ptr_null(spectatorAttach(name));
+}
+END_TEST
+
+#ifdef TETRIS_TRACE
+START_TEST(test_trace_spans) {
+  const char *path = "test_trace.json";
+  initGame();
+  userInput(Start, false);
+  updateCurrentState();
+  freeGame();
+
+  ck_assert_int_gt(traceWrite(path), 0);
+  FILE *file = fopen(path, "r");
+  ck_assert_ptr_nonnull(file);
+  static char text[1 << 16];
+  size_t size = fread(text, 1, sizeof(text) - 1, file);
+  text[size] = '\0';
+  fclose(file);
+  unlink(path);
+
+  ck_assert_ptr_nonnull(strstr(text, "\"traceEvents\""));
+  ck_assert_ptr_nonnull(
+      strstr(text, "{\"name\":\"userInput\",\"ph\":\"B\""));
+  ck_assert_ptr_nonnull(
+      strstr(text, "{\"name\":\"userInput\",\"ph\":\"E\""));
+  ck_assert_ptr_nonnull(strstr(text, "\"spawnTetromino\""));
+  ck_assert_ptr_nonnull(strstr(text, "\"updateCurrentState\""));
+  ck_assert_uint_eq(traceDropped(), 0);
+
+  // Переполненное кольцо затирает старые события, а не новые
+  for (int i = 0; i < TRACE_BUFFER_SIZE; i++) {
+    traceRecord("filler", i % 2 ? 'E' : 'B');
+  }
+  TRACE_BEGIN("last");
+  TRACE_END("last");
+  ck_assert_uint_gt(traceDropped(), 0);
+  ck_assert_int_gt(traceWrite(path), 0);
+  file = fopen(path, "r");
+  ck_assert_ptr_nonnull(file);
+  fseek(file, -1024, SEEK_END);
+  size = fread(text, 1, sizeof(text) - 1, file);
+  text[size] = '\0';
+  fclose(file);
+  unlink(path);
+  ck_assert_ptr_nonnull(strstr(text, "{\"name\":\"last\",\"ph\":\"E\""));
+}
+END_TEST
+#endif
+
+// Тесты не пишут в общую таблицу рекордов; тесту, которому нужна таблица,
+// файл задается явно, а teardown возвращает путь и при упавшей проверке
+static void leaderboardOff(void) { setLeaderboardFile(NULL); }
+
+static void leaderboardOn(void) { setLeaderboardFile(LEADERBOARD_FILE); }
+
 Suite *tetris_suite(void) {
   Suite *s;
   TCase *tc_core, *tc_movement, *tc_scoring, *tc_gameplay;
@@ -442,6 +1627,8 @@ Suite *tetris_suite(void) {
   tcase_add_test(tc_core, test_field_initialization);
   tcase_add_test(tc_core, test_tetromino_shapes);
   tcase_add_test(tc_core, test_update_current_state);
+  tcase_add_test(tc_core, test_virtual_clock);
+  tcase_add_checked_fixture(tc_core, leaderboardOff, leaderboardOn);
   suite_add_tcase(s, tc_core);
 
   // Тесты движения и управления
@@ -454,6 +1641,10 @@ Suite *tetris_suite(void) {
   tcase_add_test(tc_movement, test_tetromino_rotation);
   tcase_add_test(tc_movement, test_can_move_boundaries);
   tcase_add_test(tc_movement, test_pause_toggle);
+  tcase_add_test(tc_movement, test_pause_freezes_gravity);
+  tcase_add_test(tc_movement, test_auto_repeat);
+  tcase_add_test(tc_movement, test_next_queue);
+  tcase_add_checked_fixture(tc_movement, leaderboardOff, leaderboardOn);
   suite_add_tcase(s, tc_movement);
 
   // Тесты подсчета очков
@@ -461,6 +1652,9 @@ Suite *tetris_suite(void) {
   tcase_add_test(tc_scoring, test_score_calculation);
   tcase_add_test(tc_scoring, test_level_progression);
   tcase_add_test(tc_scoring, test_high_score);
+  tcase_add_test(tc_scoring, test_leaderboard_sorted_insert);
+  tcase_add_test(tc_scoring, test_leaderboard_per_player_limit);
+  tcase_add_checked_fixture(tc_scoring, leaderboardOff, leaderboardOn);
   suite_add_tcase(s, tc_scoring);
 
   // Тесты игрового процесса
@@ -472,9 +1666,47 @@ Suite *tetris_suite(void) {
   tcase_add_test(tc_gameplay, test_can_rotate_blocked);
   tcase_add_test(tc_gameplay, test_get_tetromino_block_invalid);
   tcase_add_test(tc_gameplay, test_drop_tetromino);
-  tcase_add_test(tc_gameplay, test_save_load_high_score);
+  tcase_add_test(tc_gameplay, test_record_load_high_score);
+  tcase_add_test(tc_gameplay, test_restart_reuses_buffers);
+  tcase_add_test(tc_gameplay, test_seed_reproducible);
+  tcase_add_test(tc_gameplay, test_ai_completes_line);
+  tcase_add_test(tc_gameplay, test_eval_features);
+  tcase_add_test(tc_gameplay, test_eval_simd_matches_scalar);
+  tcase_add_test(tc_gameplay, test_ai_lookahead);
+  tcase_add_test(tc_gameplay, test_arena_and_pool);
+  tcase_add_test(tc_gameplay, test_spectator_feed);
+  tcase_add_test(tc_gameplay, test_engine_interface);
+  tcase_add_test(tc_gameplay, test_script_actions);
+  tcase_add_test(tc_gameplay, test_garbage_lines);
+  tcase_add_test(tc_gameplay, test_snapshot_step);
+  tcase_add_test(tc_gameplay, test_session_encode);
+  tcase_add_test(tc_gameplay, test_session_resume);
+  tcase_add_test(tc_gameplay, test_board_sizes);
+  tcase_add_test(tc_gameplay, test_place_piece);
+  tcase_add_test(tc_gameplay, test_versus_rollback);
+  tcase_add_test(tc_gameplay, test_versus_peers);
+  tcase_add_test(tc_gameplay, test_vecenv_step);
+  tcase_add_test(tc_gameplay, test_timer_wheel);
+  tcase_add_checked_fixture(tc_gameplay, leaderboardOff, leaderboardOn);
   suite_add_tcase(s, tc_gameplay);
 
+#ifdef TETRIS_EVENTS
+  // Тесты событий движка (make test EVENTS=1)
+  TCase *tc_events = tcase_create("Events");
+  tcase_add_test(tc_events, test_events_line_clear);
+  tcase_add_test(tc_events, test_events_spawn_and_move);
+  tcase_add_checked_fixture(tc_events, leaderboardOff, leaderboardOn);
+  suite_add_tcase(s, tc_events);
+#endif
+
+#ifdef TETRIS_TRACE
+  // Тесты трассировки (make test TRACE=1)
+  TCase *tc_trace = tcase_create("Trace");
+  tcase_add_test(tc_trace, test_trace_spans);
+  tcase_add_checked_fixture(tc_trace, leaderboardOff, leaderboardOn);
+  suite_add_tcase(s, tc_trace);
+#endif
+
   return s;
 }
 
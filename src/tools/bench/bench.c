@@ -0,0 +1,151 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ai.h"
+#include "gameclock.h"
+#include "tetris.h"
+
+#define BENCH_VERSION 1
+#define DEFAULT_GAMES 16
+#define DEFAULT_PIECES 5000  // Ограничение длины одной игры
+#define TICK_MS 1  // Один тик — 1 мс игрового времени
+
+// Виртуальные часы: время идет только по тикам бенчмарка
+static VirtualClock_t virtual_clock;
+static bool lookahead;  // Учитывать следующую фигуру при поиске
+
+static long long nowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int compareLongLong(const void *a, const void *b) {
+  long long x = *(const long long *)a, y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+static long long percentile(const long long *sorted, long count, double p) {
+  if (count == 0) return 0;
+  long index = (long)(p * (double)(count - 1) + 0.5);
+  return sorted[index];
+}
+
+/**
+ * @brief Результаты прогона
+ */
+typedef struct {
+  long pieces;
+  long lines;
+  long long score;
+  long long *latencies;  // Длительность обработки каждой фигуры, нс
+} BenchResult_t;
+
+// Играет одну партию встроенным ботом через userInput/updateCurrentState
+static void playGame(uint32_t seed, int max_pieces, BenchResult_t *result) {
+  seedGame(seed);
+  resetGame();
+  userInput(Start, false);
+  updateCurrentState();
+
+  int pieces = 0;
+  while (game.state != GAME_OVER && pieces < max_pieces) {
+    long long start = nowNs();
+
+    AiMove_t move;
+    bool found = lookahead ? aiFindMoveLookahead(&ai_default_weights, &move)
+                           : aiFindMove(&ai_default_weights, &move);
+    if (!found) {
+      move.rotation = game.current.rotation;
+      move.x = game.current.x;
+    }
+    UserAction_t actions[AI_MAX_ACTIONS];
+    int count = aiPlanActions(move, actions);
+    for (int i = 0; i < count && game.state != GAME_OVER; i++) {
+      userInput(actions[i], false);
+      updateCurrentState();
+      virtualClockAdvance(&virtual_clock, TICK_MS);
+    }
+
+    result->latencies[result->pieces++] = nowNs() - start;
+    pieces++;
+  }
+
+  result->lines += game.lines_cleared;
+  result->score += game.info.score;
+}
+
+static void printUsage(const char *name) {
+  fprintf(stderr, "Usage: %s [--games N] [--pieces N] [--lookahead]\n", name);
+}
+
+int main(int argc, char **argv) {
+  int games = DEFAULT_GAMES;
+  int max_pieces = DEFAULT_PIECES;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+      games = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--pieces") == 0 && i + 1 < argc) {
+      max_pieces = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--lookahead") == 0) {
+      lookahead = true;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (games < 1 || max_pieces < 1) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  BenchResult_t result = {0};
+  result.latencies = malloc((size_t)games * max_pieces * sizeof(long long));
+  if (!result.latencies) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  setLeaderboardFile(NULL);
+  setGameClock(virtualClock(&virtual_clock));
+  initGame();
+
+  long long start = nowNs();
+  for (int g = 0; g < games; g++) {
+    playGame((uint32_t)(g + 1), max_pieces, &result);
+  }
+  double elapsed = (double)(nowNs() - start) / 1e9;
+
+  freeGame();
+
+  qsort(result.latencies, (size_t)result.pieces, sizeof(long long),
+        compareLongLong);
+
+  printf("{\n");
+  printf("  \"benchmark\": \"tetris-bot\",\n");
+  printf("  \"version\": %d,\n", BENCH_VERSION);
+  printf("  \"games\": %d,\n", games);
+  printf("  \"max_pieces_per_game\": %d,\n", max_pieces);
+  printf("  \"search\": \"%s\",\n", lookahead ? "lookahead" : "greedy");
+  printf("  \"pieces\": %ld,\n", result.pieces);
+  printf("  \"lines\": %ld,\n", result.lines);
+  printf("  \"total_score\": %lld,\n", result.score);
+  printf("  \"elapsed_sec\": %.6f,\n", elapsed);
+  printf("  \"pieces_per_second\": %.1f,\n",
+         elapsed > 0 ? result.pieces / elapsed : 0.0);
+  printf("  \"lines_per_second\": %.1f,\n",
+         elapsed > 0 ? result.lines / elapsed : 0.0);
+  printf("  \"piece_latency_ns\": {\"p50\": %lld, \"p90\": %lld, "
+         "\"p99\": %lld, \"max\": %lld}\n",
+         percentile(result.latencies, result.pieces, 0.50),
+         percentile(result.latencies, result.pieces, 0.90),
+         percentile(result.latencies, result.pieces, 0.99),
+         result.pieces ? result.latencies[result.pieces - 1] : 0);
+  printf("}\n");
+
+  free(result.latencies);
+  return 0;
+}
@@ -0,0 +1,285 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "dataset.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <threads.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ai.h"
+#include "placement.h"
+
+#define MAX_THREADS 256
+#define PATH_SIZE 4096
+
+/**
+ * @brief Параметры выгрузки
+ */
+typedef struct {
+  int threads;  // Потоков и шардов
+  int pieces;   // Ограничение длины партии
+  unsigned long long records;
+  uint32_t seed;
+  bool lookahead;  // Выбор с учетом следующей фигуры
+  const char *out;
+} DatasetConfig_t;
+
+/**
+ * @brief Шард, который пишет один поток
+ */
+typedef struct {
+  const DatasetConfig_t *config;
+  int shard;
+  uint64_t records;  // Записано
+  bool ok;
+} ShardJob_t;
+
+static long long nowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static bool writeAll(int fd, const void *data, size_t size) {
+  const char *bytes = data;
+  while (size > 0) {
+    ssize_t n = write(fd, bytes, size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    bytes += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+// Описание столбца по имени поля DatasetBlock_t
+#define COLUMN(field)                                 \
+  {#field, (uint32_t)offsetof(DatasetBlock_t, field), \
+   (uint32_t)(sizeof(((DatasetBlock_t *)0)->field) / DATASET_BLOCK)}
+
+static void fillHeader(DatasetHeader_t *header, const ShardJob_t *job) {
+  static const DatasetColumn_t columns[DATASET_COLUMNS] = {
+      COLUMN(placements), COLUMN(boards), COLUMN(features),
+      COLUMN(seeds),      COLUMN(plies),  COLUMN(current),
+      COLUMN(next),       COLUMN(chosen), COLUMN(lines)};
+  *header = (DatasetHeader_t){
+      .magic = DATASET_MAGIC,
+      .version = DATASET_VERSION,
+      .records = job->records,
+      .header_size = DATASET_HEADER_SIZE,
+      .block_size = sizeof(DatasetBlock_t),
+      .block_records = DATASET_BLOCK,
+      .width = FIELD_WIDTH,
+      .height = FIELD_HEIGHT,
+      .slots = DATASET_SLOTS,
+      .features = FEATURE_COUNT,
+      .shard = (uint32_t)job->shard,
+      .shards = (uint32_t)job->config->threads,
+      .seed = job->config->seed,
+      .column_count = DATASET_COLUMNS,
+  };
+  memcpy(header->columns, columns, sizeof(columns));
+}
+
+// Записывает позицию в строку i блока, ставит выбранное размещение и
+// возвращает false, если партия окончена
+static bool recordPiece(const DatasetConfig_t *config, DatasetBlock_t *block,
+                        int i) {
+  AiMove_t moves[AI_MAX_CANDIDATES];
+  int count = aiListMoves(&ai_default_weights, moves);
+  uint64_t placements = 0;
+  int best = -1;
+  for (int m = 0; m < count; m++) {
+    placements |= 1ull << DATASET_SLOT(moves[m].rotation, moves[m].x);
+    if (best < 0 || moves[m].score > moves[best].score) best = m;
+  }
+  AiMove_t move = best >= 0 ? moves[best] : (AiMove_t){0};
+  if (config->lookahead && !aiFindMoveLookahead(&ai_default_weights, &move)) {
+    best = -1;
+  }
+
+  Bitboard_t board = boardFromField(game.cells);
+  BoardFeatures_t features;
+  evaluateBoards(&board, 1, &features);
+  block->placements[i] = placements;
+  memcpy(block->boards[i], board.rows, sizeof(block->boards[i]));
+  memcpy(block->features[i], features.values, sizeof(block->features[i]));
+  block->current[i] = (uint8_t)game.current.type;
+  block->next[i] = (uint8_t)peekNextPiece(0);
+
+  PlaceResult_t result;
+  if (best >= 0 && placePiece(move.rotation, move.x, &result)) {
+    block->chosen[i] = (uint8_t)DATASET_SLOT(move.rotation, move.x);
+    block->lines[i] = (uint8_t)result.lines;
+  } else {
+    block->chosen[i] = DATASET_NO_SLOT;
+    block->lines[i] = 0;
+    dropPiece();
+  }
+  return game.state != GAME_OVER;
+}
+
+// Играет партии шарда, пока не наберет его долю записей. Партии шарда —
+// зерна seed + shard, seed + shard + shards, ...
+static bool playShard(ShardJob_t *job, int fd, DatasetBlock_t *block) {
+  const DatasetConfig_t *config = job->config;
+  uint64_t quota = config->records / (uint64_t)config->threads +
+                   ((uint64_t)job->shard < config->records % config->threads);
+  uint32_t seed = config->seed + (uint32_t)job->shard;
+  int fill = 0;
+
+  while (job->records < quota) {
+    seedGame(seed);
+    resetGame();
+    userInput(Start, false);
+    bool playing = true;
+    for (int ply = 0; playing && ply < config->pieces && job->records < quota;
+         ply++) {
+      block->seeds[fill] = seed;
+      block->plies[fill] = (uint32_t)ply;
+      playing = recordPiece(config, block, fill);
+      job->records++;
+      if (++fill == DATASET_BLOCK) {
+        if (!writeAll(fd, block, sizeof(DatasetBlock_t))) return false;
+        memset(block, 0, sizeof(DatasetBlock_t));
+        fill = 0;
+      }
+    }
+    seed += (uint32_t)config->threads;
+  }
+  return fill == 0 || writeAll(fd, block, sizeof(DatasetBlock_t));
+}
+
+// Поток: свой движок, свой буфер блока и свой файл — без блокировок.
+// Шард пишется во временный файл и появляется под своим именем целиком
+static int shardWorker(void *arg) {
+  ShardJob_t *job = arg;
+  char path[PATH_SIZE], tmp[PATH_SIZE];
+  const char *out = job->config->out;
+  int length = snprintf(path, sizeof(path), "%s/shard-%03d.bgd", out,
+                        job->shard);
+  snprintf(tmp, sizeof(tmp), "%s/shard-%03d.bgd.tmp", out, job->shard);
+  if (length < 0 || length + 4 >= PATH_SIZE) return 0;  // Путь не влезает
+
+  union {
+    DatasetHeader_t header;
+    char bytes[DATASET_HEADER_SIZE];
+  } page = {0};
+  DatasetBlock_t *block = calloc(1, sizeof(DatasetBlock_t));
+  int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  job->ok = block && fd >= 0 && writeAll(fd, page.bytes, sizeof(page));
+  if (job->ok) {
+    initGame();
+    job->ok = playShard(job, fd, block);
+    freeGame();
+  }
+  if (job->ok) {
+    // Число записей известно только в конце
+    fillHeader(&page.header, job);
+    ssize_t n = pwrite(fd, page.bytes, sizeof(page), 0);
+    job->ok = n == (ssize_t)sizeof(page) && fsync(fd) == 0;
+  }
+  if (fd >= 0) job->ok = close(fd) == 0 && job->ok;
+  job->ok = job->ok && rename(tmp, path) == 0;
+  if (!job->ok) unlink(tmp);
+  free(block);
+  return 0;
+}
+
+static void printUsage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [--records N] [--threads N] [--pieces N] [--seed N]\n"
+          "          [--out DIR] [--lookahead]\n",
+          name);
+}
+
+static bool parseArgs(int argc, char **argv, DatasetConfig_t *config) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (strcmp(arg, "--lookahead") == 0) {
+      config->lookahead = true;
+      continue;
+    }
+    if (i + 1 >= argc) return false;
+    const char *value = argv[++i];
+    if (strcmp(arg, "--records") == 0) {
+      config->records = strtoull(value, NULL, 10);
+    } else if (strcmp(arg, "--threads") == 0) {
+      config->threads = atoi(value);
+    } else if (strcmp(arg, "--pieces") == 0) {
+      config->pieces = atoi(value);
+    } else if (strcmp(arg, "--seed") == 0) {
+      config->seed = (uint32_t)strtoul(value, NULL, 10);
+    } else if (strcmp(arg, "--out") == 0) {
+      config->out = value;
+    } else {
+      return false;
+    }
+  }
+  return config->threads >= 1 && config->threads <= MAX_THREADS &&
+         config->pieces >= 1 && config->records >= 1;
+}
+
+int main(int argc, char **argv) {
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  DatasetConfig_t config = {
+      .threads = cores > 0 ? (int)(cores < MAX_THREADS ? cores : MAX_THREADS)
+                           : 1,
+      .pieces = 1000,
+      .records = 1000000,
+      .seed = 1,
+      .out = "dataset",
+  };
+  if (!parseArgs(argc, argv, &config)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (mkdir(config.out, 0755) != 0 && errno != EEXIST) {
+    fprintf(stderr, "Cannot create %s\n", config.out);
+    return 1;
+  }
+
+  setLeaderboardFile(NULL);
+
+  static ShardJob_t jobs[MAX_THREADS];
+  thrd_t threads[MAX_THREADS];
+  bool started[MAX_THREADS];
+  long long start = nowNs();
+  for (int t = 0; t < config.threads; t++) {
+    jobs[t] = (ShardJob_t){.config = &config, .shard = t};
+    started[t] = thrd_create(&threads[t], shardWorker, &jobs[t]) ==
+                 thrd_success;
+    if (!started[t]) shardWorker(&jobs[t]);  // Без потока пишем сами
+  }
+  uint64_t records = 0;
+  int status = 0;
+  for (int t = 0; t < config.threads; t++) {
+    if (started[t]) thrd_join(threads[t], NULL);
+    records += jobs[t].records;
+    if (!jobs[t].ok) {
+      fprintf(stderr, "Cannot write shard %d to %s\n", t, config.out);
+      status = 1;
+    }
+  }
+  double elapsed = (double)(nowNs() - start) / 1e9;
+
+  printf("{\n");
+  printf("  \"dataset\": \"%s\",\n", config.out);
+  printf("  \"version\": %d,\n", DATASET_VERSION);
+  printf("  \"shards\": %d,\n", config.threads);
+  printf("  \"search\": \"%s\",\n", config.lookahead ? "lookahead" : "greedy");
+  printf("  \"records\": %llu,\n", (unsigned long long)records);
+  printf("  \"record_bytes\": %zu,\n", sizeof(DatasetBlock_t) / DATASET_BLOCK);
+  printf("  \"elapsed_sec\": %.6f,\n", elapsed);
+  printf("  \"records_per_second\": %.1f\n",
+         elapsed > 0 ? records / elapsed : 0.0);
+  printf("}\n");
+  return status;
+}
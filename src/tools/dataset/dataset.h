@@ -0,0 +1,85 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <stdint.h>
+
+#include "eval.h"
+#include "tetris.h"
+
+#define DATASET_MAGIC 0x31444742u  // "BGD1" в little-endian
+#define DATASET_VERSION 1
+#define DATASET_HEADER_SIZE 4096  // Заголовок занимает страницу
+#define DATASET_BLOCK 4096        // Записей в блоке
+#define DATASET_NAME_SIZE 16
+#define DATASET_COLUMNS 9
+
+// Размещение: ячейка rotation * DATASET_SLOT_X + x + DATASET_SLOT_SHIFT
+#define DATASET_SLOT_SHIFT 3  // Наименьший X размещения — -3
+#define DATASET_SLOT_X (FIELD_WIDTH + DATASET_SLOT_SHIFT)
+#define DATASET_SLOTS (4 * DATASET_SLOT_X)
+#define DATASET_SLOT(rotation, x) \
+  ((rotation) * DATASET_SLOT_X + (x) + DATASET_SLOT_SHIFT)
+#define DATASET_NO_SLOT 0xFF  // Фигура сброшена без выбора
+
+_Static_assert(DATASET_SLOTS <= 64, "Placements are stored as uint64_t");
+
+/**
+ * @brief Столбец блока
+ */
+typedef struct {
+  char name[DATASET_NAME_SIZE];  // Имя поля DatasetBlock_t
+  uint32_t offset;               // Смещение от начала блока, байт
+  uint32_t size;                 // Байт на запись
+} DatasetColumn_t;
+
+/**
+ * @brief Заголовок шарда
+ *
+ * Занимает первые DATASET_HEADER_SIZE байт файла, остаток страницы
+ * заполнен нулями. Таблица столбцов позволяет читать шард без этого
+ * заголовка: столбец name блока b начинается со смещения
+ * header_size + b * block_size + offset.
+ */
+typedef struct {
+  uint32_t magic;  // DATASET_MAGIC
+  uint32_t version;
+  uint64_t records;        // Записей в шарде
+  uint32_t header_size;    // DATASET_HEADER_SIZE
+  uint32_t block_size;     // sizeof(DatasetBlock_t)
+  uint32_t block_records;  // DATASET_BLOCK
+  uint16_t width, height;  // Размер поля
+  uint32_t slots;          // DATASET_SLOTS
+  uint32_t features;       // FEATURE_COUNT
+  uint32_t shard;          // Номер шарда
+  uint32_t shards;         // Всего шардов
+  uint32_t seed;           // Зерно первой партии набора
+  uint32_t column_count;   // DATASET_COLUMNS
+  DatasetColumn_t columns[DATASET_COLUMNS];
+} DatasetHeader_t;
+
+/**
+ * @brief Блок записей по столбцам
+ *
+ * Запись — позиция перед появлением фигуры на поле: i-й элемент каждого
+ * столбца. Размеры столбцов кратны DATASET_BLOCK, поэтому каждый столбец
+ * выровнен по своему типу, а блоки в отображенном файле — по странице.
+ * Последний блок шарда дополнен нулевыми записями.
+ */
+typedef struct {
+  uint64_t placements[DATASET_BLOCK];  // Бит DATASET_SLOT — есть размещение
+  uint16_t boards[DATASET_BLOCK][FIELD_HEIGHT];    // Бит x строки y — клетка
+  int16_t features[DATASET_BLOCK][FEATURE_COUNT];  // Признаки поля
+  uint32_t seeds[DATASET_BLOCK];   // Зерно партии
+  uint32_t plies[DATASET_BLOCK];   // Номер фигуры в партии с 0
+  uint8_t current[DATASET_BLOCK];  // Вид фигуры, 0..TETROMINO_COUNT-1
+  uint8_t next[DATASET_BLOCK];     // Вид следующей фигуры
+  uint8_t chosen[DATASET_BLOCK];   // DATASET_SLOT выбора бота
+  uint8_t lines[DATASET_BLOCK];    // Линий очищено выбором
+} DatasetBlock_t;
+
+_Static_assert(sizeof(DatasetHeader_t) <= DATASET_HEADER_SIZE,
+               "Header must fit its page");
+_Static_assert(sizeof(DatasetBlock_t) % DATASET_HEADER_SIZE == 0,
+               "Blocks must stay page-aligned");
+
+#endif  // DATASET_H
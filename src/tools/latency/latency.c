@@ -0,0 +1,191 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_GAME "build/bin/tetris"
+#define DEFAULT_INPUTS 2000
+#define DEFAULT_INTERVAL_MS 5  // Пауза между нажатиями
+#define STARTUP_MS 200         // Время на запуск игры и первый кадр
+#define EXIT_TIMEOUT_MS 5000   // Ожидание выхода игры после Q
+#define RESTART_EVERY 100      // Через столько нажатий повторяется S
+#define PTY_ROWS 24
+#define PTY_COLS 80
+#define REPORT_SIZE 65536  // Отчет игры: гистограмма занимает несколько КБ
+
+// Влево, влево, вправо, вправо, поворот: фигура остается у центра. Стрелки
+// в режиме keypad, который включает ncurses
+static const char *const keys[] = {"\x1bOD", "\x1bOD", "\x1bOC", "\x1bOC",
+                                   " "};
+#define KEY_COUNT (int)(sizeof(keys) / sizeof(keys[0]))
+static long output_bytes;
+
+static long long nowMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Запускает игру на подчиненной стороне нового псевдотерминала
+static pid_t spawnGame(const char *game, const char *report,
+                       const char *session, int *master) {
+  *master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+  const char *slave_name = NULL;
+  if (*master < 0 || grantpt(*master) != 0 || unlockpt(*master) != 0 ||
+      !(slave_name = ptsname(*master))) {
+    return -1;
+  }
+  char slave_path[64];
+  snprintf(slave_path, sizeof(slave_path), "%s", slave_name);
+
+  pid_t child = fork();
+  if (child != 0) return child;
+
+  // Дочерний процесс: терминал становится управляющим и стандартным
+  setsid();
+  int slave = open(slave_path, O_RDWR);
+  if (slave < 0) _exit(127);
+  ioctl(slave, TIOCSCTTY, 0);
+  struct winsize size = {.ws_row = PTY_ROWS, .ws_col = PTY_COLS};
+  ioctl(slave, TIOCSWINSZ, &size);
+  dup2(slave, STDIN_FILENO);
+  dup2(slave, STDOUT_FILENO);
+  dup2(slave, STDERR_FILENO);
+  if (slave > STDERR_FILENO) close(slave);
+  setenv("TERM", "xterm", 1);
+  execl(game, game, "--probe", report, "--session", session, (char *)NULL);
+  _exit(127);
+}
+
+// Читает вывод игры до deadline; false — игра закрыла терминал
+static bool drain(int master, long long deadline) {
+  char buffer[4096];
+  for (;;) {
+    long long left = deadline - nowMs();
+    struct pollfd output = {.fd = master, .events = POLLIN};
+    int ready = poll(&output, 1, left > 0 ? (int)left : 0);
+    if (ready < 0 && errno == EINTR) continue;
+    if (ready <= 0) return ready == 0;
+    ssize_t size = read(master, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR) continue;
+    // После выхода игры чтение мастера дает EIO
+    if (size <= 0) return false;
+    output_bytes += size;
+  }
+}
+
+static bool sendKey(int master, const char *key) {
+  size_t length = strlen(key);
+  return write(master, key, length) == (ssize_t)length;
+}
+
+// Копирует отчет игры в stdout и считает вводы, которые учла игра:
+// с кадром, без кадра и не поместившиеся в очередь
+static bool printReport(const char *path, long *counted) {
+  FILE *file = fopen(path, "r");
+  if (!file) return false;
+  static char report[REPORT_SIZE];
+  size_t size = fread(report, 1, sizeof(report) - 1, file);
+  fclose(file);
+  report[size] = '\0';
+  fwrite(report, 1, size, stdout);
+
+  static const char *const fields[] = {"\"inputs\": ", "\"unanswered\": ",
+                                       "\"dropped\": "};
+  *counted = 0;
+  for (int i = 0; i < 3; i++) {
+    const char *field = strstr(report, fields[i]);
+    if (!field) return false;
+    *counted += atol(field + strlen(fields[i]));
+  }
+  return true;
+}
+
+static void printUsage(const char *name) {
+  fprintf(stderr, "Usage: %s [--game PATH] [--inputs N] [--interval MS]\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  const char *game = DEFAULT_GAME;
+  long inputs = DEFAULT_INPUTS;
+  int interval = DEFAULT_INTERVAL_MS;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--game") == 0 && i + 1 < argc) {
+      game = argv[++i];
+    } else if (strcmp(argv[i], "--inputs") == 0 && i + 1 < argc) {
+      inputs = atol(argv[++i]);
+    } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+      interval = atoi(argv[++i]);
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (inputs < 1 || interval < 0) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Отчет и сохранение партии при выходе — во временных файлах
+  char report[64], session[64];
+  snprintf(report, sizeof(report), "/tmp/tetris_latency_%d.json",
+           (int)getpid());
+  snprintf(session, sizeof(session), "/tmp/tetris_latency_%d.dat",
+           (int)getpid());
+  int master;
+  pid_t child = spawnGame(game, report, session, &master);
+  if (child < 0) {
+    fprintf(stderr, "Cannot start %s on a pseudo-terminal\n", game);
+    return 1;
+  }
+
+  // Нажатия идут с постоянным шагом; вывод все время вычитывается, иначе
+  // игра встанет на записи в терминал
+  bool alive = drain(master, nowMs() + STARTUP_MS) && sendKey(master, "s");
+  long sent = 0;
+  for (; alive && sent < inputs; sent++) {
+    // Start после конца игры начинает новую, в игре ничего не делает
+    bool restart = sent % RESTART_EVERY == RESTART_EVERY - 1;
+    const char *key = restart ? "s" : keys[sent % KEY_COUNT];
+    alive = sendKey(master, key) && drain(master, nowMs() + interval);
+  }
+  if (alive) sendKey(master, "q");
+  long long deadline = nowMs() + EXIT_TIMEOUT_MS;
+  while (drain(master, deadline) && nowMs() < deadline) {
+  }
+
+  int status = 0;
+  if (waitpid(child, &status, WNOHANG) == 0) {
+    kill(child, SIGTERM);
+    waitpid(child, &status, 0);
+  }
+  close(master);
+
+  fprintf(stderr, "keys %ld output_bytes %ld exit %d\n", sent, output_bytes,
+          WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+  long counted = 0;
+  bool printed = printReport(report, &counted);
+  unlink(report);
+  unlink(session);
+  if (!printed || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "Game did not finish cleanly\n");
+    return 1;
+  }
+  // Каждое нажатие, включая первое S и Q, должно попасть в замер
+  if (counted != sent + 2) {
+    fprintf(stderr, "Game counted %ld of %ld keys\n", counted, sent + 2);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,304 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ai.h"
+#include "cli.h"
+#include "gameclock.h"
+#include "histogram.h"
+#include "tetris.h"
+
+#define SOAK_VERSION 1
+#define DEFAULT_PIECES 1000000
+#define DEFAULT_INTERVAL 100000     // Фигур между замерами
+#define DEFAULT_GAME_PIECES 2000    // После стольких фигур игра перезапускается
+#define DEFAULT_RSS_GROWTH_KB 1024  // Допустимый рост RSS после первого замера
+#define DEFAULT_ALLOC_GROWTH 0      // Допустимый рост числа живых выделений
+#define DEFAULT_LATENCY_DRIFT 50    // Допустимый рост p90 такта, %
+#define TICK_MS 1  // Один тик — 1 мс игрового времени
+
+// Счетчики выделений памяти. Вызовы malloc/calloc/realloc/aligned_alloc/free
+// из движка и утилиты перехватываются ключами компоновщика --wrap
+static long alloc_calls;
+static long live_allocs;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_aligned_alloc(size_t alignment, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size) {
+  void *ptr = __real_malloc(size);
+  if (ptr) alloc_calls++, live_allocs++;
+  return ptr;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  void *ptr = __real_calloc(count, size);
+  if (ptr) alloc_calls++, live_allocs++;
+  return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  void *result = __real_realloc(ptr, size);
+  if (result) {
+    alloc_calls++;
+    if (!ptr) live_allocs++;
+  }
+  return result;
+}
+
+void *__wrap_aligned_alloc(size_t alignment, size_t size) {
+  void *ptr = __real_aligned_alloc(alignment, size);
+  if (ptr) alloc_calls++, live_allocs++;
+  return ptr;
+}
+
+void __wrap_free(void *ptr) {
+  if (ptr) live_allocs--;
+  __real_free(ptr);
+}
+
+// Виртуальные часы: время идет только по тикам прогона
+static VirtualClock_t virtual_clock;
+
+static long long nowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Резидентная память процесса по /proc/self/statm, КБ
+static long rssKb(void) {
+  long pages = 0;
+  FILE *file = fopen("/proc/self/statm", "r");
+  if (file) {
+    if (fscanf(file, "%*d %ld", &pages) != 1) pages = 0;
+    fclose(file);
+  }
+  return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * @brief Замер за интервал прогона
+ */
+typedef struct {
+  long pieces;  // Всего фигур к моменту замера
+  long restarts;
+  long rss_kb;
+  long alloc_calls;  // Вызовов выделения за интервал
+  long live_allocs;
+  long long p50, p90, p99, max;  // Длительность такта, нс
+} SoakSample_t;
+
+/**
+ * @brief Параметры и состояние прогона
+ */
+typedef struct {
+  long pieces;
+  long interval;
+  int game_pieces;
+  bool render;  // Отрисовка каждого такта через ncurses
+  Histogram_t ticks;  // Такты текущего интервала, нс
+  long restarts;
+} Soak_t;
+
+// Один такт: действие и обновление состояния, как в игровом цикле
+static void tick(Soak_t *soak, UserAction_t action) {
+  long long start = nowNs();
+  userInput(action, false);
+  GameInfo_t info = updateCurrentState();
+  if (soak->render) drawGame(info);
+  virtualClockAdvance(&virtual_clock, TICK_MS);
+
+  histogramAdd(&soak->ticks, nowNs() - start);
+}
+
+// Ставит одну фигуру встроенным ботом; перезапускает закончившуюся игру
+static void playPiece(Soak_t *soak, int *game_pieces) {
+  if (game.state == GAME_OVER || *game_pieces >= soak->game_pieces) {
+    if (game.state != GAME_OVER) recordGameResult();
+    resetGame();
+    tick(soak, Start);
+    soak->restarts++;
+    *game_pieces = 0;
+  }
+
+  AiMove_t move;
+  if (!aiFindMove(&ai_default_weights, &move)) {
+    move.rotation = game.current.rotation;
+    move.x = game.current.x;
+  }
+  UserAction_t actions[AI_MAX_ACTIONS];
+  int count = aiPlanActions(move, actions);
+  for (int i = 0; i < count && game.state != GAME_OVER; i++) {
+    tick(soak, actions[i]);
+  }
+  (*game_pieces)++;
+}
+
+static SoakSample_t takeSample(Soak_t *soak, long pieces, long *last_calls) {
+  SoakSample_t sample = {
+      .pieces = pieces,
+      .restarts = soak->restarts,
+      .rss_kb = rssKb(),
+      .alloc_calls = alloc_calls - *last_calls,
+      .live_allocs = live_allocs,
+      .p50 = histogramPercentile(&soak->ticks, 0.50),
+      .p90 = histogramPercentile(&soak->ticks, 0.90),
+      .p99 = histogramPercentile(&soak->ticks, 0.99),
+      .max = soak->ticks.max};
+  *last_calls = alloc_calls;
+  histogramReset(&soak->ticks);
+  return sample;
+}
+
+static int compareLongLong(const void *a, const void *b) {
+  long long x = *(const long long *)a, y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+// Медиана p90 по замерам [from, to); отдельный шумный интервал ее не сдвигает.
+// values — место под to - from значений
+static long long medianP90(const SoakSample_t *samples, long from, long to,
+                           long long *values) {
+  for (long s = from; s < to; s++) values[s - from] = samples[s].p90;
+  qsort(values, (size_t)(to - from), sizeof(long long), compareLongLong);
+  return values[(to - from) / 2];
+}
+
+static void printUsage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [--pieces N] [--interval N] [--game-pieces N] "
+          "[--render]\n"
+          "          [--leaderboard FILE] [--max-rss-growth KB] "
+          "[--max-alloc-growth N]\n"
+          "          [--max-latency-drift PERCENT]\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  static Soak_t soak = {.pieces = DEFAULT_PIECES,
+                 .interval = DEFAULT_INTERVAL,
+                 .game_pieces = DEFAULT_GAME_PIECES};
+  const char *leaderboard = NULL;
+  long max_rss_growth = DEFAULT_RSS_GROWTH_KB;
+  long max_alloc_growth = DEFAULT_ALLOC_GROWTH;
+  long max_latency_drift = DEFAULT_LATENCY_DRIFT;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--pieces") == 0 && i + 1 < argc) {
+      soak.pieces = atol(argv[++i]);
+    } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+      soak.interval = atol(argv[++i]);
+    } else if (strcmp(argv[i], "--game-pieces") == 0 && i + 1 < argc) {
+      soak.game_pieces = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--render") == 0) {
+      soak.render = true;
+    } else if (strcmp(argv[i], "--leaderboard") == 0 && i + 1 < argc) {
+      leaderboard = argv[++i];
+    } else if (strcmp(argv[i], "--max-rss-growth") == 0 && i + 1 < argc) {
+      max_rss_growth = atol(argv[++i]);
+    } else if (strcmp(argv[i], "--max-alloc-growth") == 0 && i + 1 < argc) {
+      max_alloc_growth = atol(argv[++i]);
+    } else if (strcmp(argv[i], "--max-latency-drift") == 0 && i + 1 < argc) {
+      max_latency_drift = atol(argv[++i]);
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (soak.pieces < 1 || soak.interval < 1 || soak.game_pieces < 1 ||
+      soak.pieces / soak.interval < 2) {
+    printUsage(argv[0]);
+    fprintf(stderr, "At least two intervals are needed to measure drift\n");
+    return 1;
+  }
+
+  long samples_count = soak.pieces / soak.interval;
+  SoakSample_t *samples = malloc((size_t)samples_count * sizeof(SoakSample_t));
+  long long *p90s = malloc((size_t)samples_count * sizeof(long long));
+  if (!samples || !p90s) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  // Отчет пишется в исходный stdout; ncurses выводит кадры в /dev/null
+  FILE *report = stdout;
+  if (soak.render) {
+    report = fdopen(dup(STDOUT_FILENO), "w");
+    if (!report || !freopen("/dev/null", "w", stdout)) {
+      fprintf(stderr, "Cannot redirect renderer output\n");
+      return 1;
+    }
+    setenv("TERM", "xterm", 1);
+    initInterface();
+  }
+
+  setLeaderboardFile(leaderboard);
+  setGameClock(virtualClock(&virtual_clock));
+  initGame();
+  seedGame(1);
+  resetGame();
+  tick(&soak, Start);
+
+  long last_calls = alloc_calls;
+  int game_pieces = 0;
+  long long start = nowNs();
+  for (long s = 0; s < samples_count; s++) {
+    for (long p = 0; p < soak.interval; p++) playPiece(&soak, &game_pieces);
+    samples[s] = takeSample(&soak, (s + 1) * soak.interval, &last_calls);
+  }
+  double elapsed = (double)(nowNs() - start) / 1e9;
+
+  freeGame();
+  if (soak.render) cleanupInterface();
+
+  // Первый интервал — прогрев: арены и буферы ncurses растут до рабочего
+  // размера, поэтому рост памяти считается от него. Дрейф задержки — разница
+  // медиан p90 второй и первой половины замеров
+  const SoakSample_t *first = &samples[0];
+  const SoakSample_t *last = &samples[samples_count - 1];
+  long rss_growth = last->rss_kb - first->rss_kb;
+  long alloc_growth = last->live_allocs - first->live_allocs;
+  long half = samples_count / 2;
+  long long early = medianP90(samples, 0, half, p90s);
+  long long late = medianP90(samples, half, samples_count, p90s);
+  long long latency_drift = early > 0 ? (late - early) * 100 / early : 0;
+  bool failed = rss_growth > max_rss_growth ||
+                alloc_growth > max_alloc_growth ||
+                latency_drift > max_latency_drift;
+
+  fprintf(report, "{\n");
+  fprintf(report, "  \"soak\": \"tetris-bot\",\n");
+  fprintf(report, "  \"version\": %d,\n", SOAK_VERSION);
+  fprintf(report, "  \"render\": %s,\n", soak.render ? "true" : "false");
+  fprintf(report, "  \"elapsed_sec\": %.6f,\n", elapsed);
+  fprintf(report, "  \"samples\": [\n");
+  for (long s = 0; s < samples_count; s++) {
+    const SoakSample_t *x = &samples[s];
+    fprintf(report,
+            "    {\"pieces\": %ld, \"restarts\": %ld, \"rss_kb\": %ld, "
+            "\"alloc_calls\": %ld, \"live_allocs\": %ld, "
+            "\"tick_ns\": {\"p50\": %lld, \"p90\": %lld, \"p99\": %lld, "
+            "\"max\": %lld}}%s\n",
+            x->pieces, x->restarts, x->rss_kb, x->alloc_calls,
+            x->live_allocs, x->p50, x->p90, x->p99, x->max,
+            s + 1 < samples_count ? "," : "");
+  }
+  fprintf(report, "  ],\n");
+  fprintf(report, "  \"rss_growth_kb\": %ld,\n", rss_growth);
+  fprintf(report, "  \"live_alloc_growth\": %ld,\n", alloc_growth);
+  fprintf(report, "  \"latency_p90_drift_percent\": %lld,\n", latency_drift);
+  fprintf(report, "  \"passed\": %s\n", failed ? "false" : "true");
+  fprintf(report, "}\n");
+  fclose(report);
+
+  free(p90s);
+  free(samples);
+  return failed ? 2 : 0;
+}
@@ -0,0 +1,391 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <unistd.h>
+
+#include "ai.h"
+#include "arena.h"
+#include "placement.h"
+#include "tetris.h"
+
+#define CHECKPOINT_MAGIC "tetris-tune"
+#define CHECKPOINT_VERSION 2  // 2 — партии без гравитации (placePiece)
+#define MAX_POPULATION 1024
+#define MAX_THREADS 256
+
+#define OFFSPRING_SHARE 0.3   // Доля популяции, заменяемая потомками
+#define TOURNAMENT_SHARE 0.1  // Доля популяции в турнире
+#define MUTATION_RATE 0.05
+#define MUTATION_STEP 0.2
+
+/**
+ * @brief Параметры настройки
+ */
+typedef struct {
+  int threads;
+  int generations;  // Сколько поколений выполнить за запуск
+  int population;
+  int games;   // Партий на одну особь (зерна 1..games)
+  int pieces;  // Ограничение длины партии
+  uint32_t seed;
+  const char *checkpoint;
+} TuneConfig_t;
+
+/**
+ * @brief Особь: вектор весов и его приспособленность
+ */
+typedef struct {
+  AiWeights_t weights;
+  double fitness;  // Среднее число очищенных линий за партию
+  bool evaluated;
+} Individual_t;
+
+/**
+ * @brief Состояние оптимизатора, сохраняемое в контрольной точке
+ */
+typedef struct {
+  Individual_t individuals[MAX_POPULATION];
+  int size;
+  int generation;
+  uint32_t rng;
+} Population_t;
+
+/**
+ * @brief Пакет партий для пула потоков
+ */
+typedef struct {
+  const TuneConfig_t *config;
+  Population_t *population;
+  int pending[MAX_POPULATION];  // Особи без оценки
+  int pending_count;
+  atomic_int next_task;  // Следующая партия (особь × зерно)
+  long *lines;           // Результат каждой партии
+} EvalJob_t;
+
+static uint32_t nextRandom(uint32_t *state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+static double randomUnit(uint32_t *state) {
+  return (double)nextRandom(state) / 4294967296.0;
+}
+
+static void normalize(AiWeights_t *w) {
+  double norm = 0.0;
+  for (int f = 0; f < FEATURE_COUNT; f++) norm += w->weights[f] * w->weights[f];
+  norm = sqrt(norm);
+  if (norm > 0.0) {
+    for (int f = 0; f < FEATURE_COUNT; f++) w->weights[f] /= norm;
+  }
+}
+
+// Играет партию ботом с заданными весами; возвращает число линий. Фигуры
+// ставятся сразу на место, без нажатий и гравитации
+static long playGame(const AiWeights_t *weights, uint32_t seed, int pieces) {
+  seedGame(seed);
+  resetGame();
+  userInput(Start, false);
+
+  for (int i = 0; i < pieces && game.state != GAME_OVER; i++) {
+    AiMove_t move;
+    bool found = aiFindMove(weights, &move);
+    if (!found || !placePiece(move.rotation, move.x, NULL)) dropPiece();
+  }
+  return game.lines_cleared;
+}
+
+// Поток пула: у каждого потока свой экземпляр движка
+static int evalWorker(void *arg) {
+  EvalJob_t *job = arg;
+  int games = job->config->games;
+  int total = job->pending_count * games;
+
+  initGame();
+  for (;;) {
+    int task = atomic_fetch_add(&job->next_task, 1);
+    if (task >= total) break;
+    const Individual_t *ind =
+        &job->population->individuals[job->pending[task / games]];
+    job->lines[task] = playGame(&ind->weights, (uint32_t)(task % games + 1),
+                                job->config->pieces);
+  }
+  freeGame();
+  return 0;
+}
+
+// Оценивает все особи без оценки, распределяя партии по потокам
+static bool evaluatePopulation(const TuneConfig_t *config,
+                               Population_t *population) {
+  static EvalJob_t job;
+  job.config = config;
+  job.population = population;
+  job.pending_count = 0;
+  for (int i = 0; i < population->size; i++) {
+    if (!population->individuals[i].evaluated) {
+      job.pending[job.pending_count++] = i;
+    }
+  }
+  if (job.pending_count == 0) return true;
+
+  // Буфер результатов живет до конца поколения — берем его из арены
+  Arena_t *arena = threadArena();
+  if (!arena) return false;
+  size_t mark = arenaMark(arena);
+  size_t lines_size = (size_t)job.pending_count * config->games * sizeof(long);
+  job.lines = arenaAlloc(arena, lines_size);
+  if (!job.lines) return false;
+  memset(job.lines, 0, lines_size);
+  atomic_store(&job.next_task, 0);
+
+  thrd_t threads[MAX_THREADS];
+  int started = 0;
+  for (; started < config->threads; started++) {
+    if (thrd_create(&threads[started], evalWorker, &job) != thrd_success) break;
+  }
+  if (started == 0) evalWorker(&job);  // Без потоков считаем сами
+  for (int t = 0; t < started; t++) thrd_join(threads[t], NULL);
+
+  for (int p = 0; p < job.pending_count; p++) {
+    long sum = 0;
+    for (int g = 0; g < config->games; g++) {
+      sum += job.lines[p * config->games + g];
+    }
+    Individual_t *ind = &population->individuals[job.pending[p]];
+    ind->fitness = (double)sum / config->games;
+    ind->evaluated = true;
+  }
+  arenaRelease(arena, mark);
+  return true;
+}
+
+static int compareFitness(const void *a, const void *b) {
+  double x = ((const Individual_t *)a)->fitness;
+  double y = ((const Individual_t *)b)->fitness;
+  return (x < y) - (x > y);  // По убыванию
+}
+
+// Турнир: лучшие две особи из случайной выборки
+static void tournament(Population_t *population, int *first, int *second) {
+  int size = (int)(population->size * TOURNAMENT_SHARE);
+  if (size < 2) size = 2;
+  *first = *second = -1;
+  for (int i = 0; i < size; i++) {
+    int pick = (int)(nextRandom(&population->rng) % (uint32_t)population->size);
+    double fit = population->individuals[pick].fitness;
+    if (*first < 0 || fit > population->individuals[*first].fitness) {
+      *second = *first;
+      *first = pick;
+    } else if (pick != *first &&
+               (*second < 0 ||
+                fit > population->individuals[*second].fitness)) {
+      *second = pick;
+    }
+  }
+  if (*second < 0) *second = *first;
+}
+
+// Заменяет худшие особи потомками (популяция отсортирована по убыванию)
+static void breed(Population_t *population) {
+  int offspring = (int)(population->size * OFFSPRING_SHARE);
+  if (offspring < 1) offspring = 1;
+  Individual_t children[MAX_POPULATION];
+
+  for (int c = 0; c < offspring; c++) {
+    int a, b;
+    tournament(population, &a, &b);
+    const Individual_t *pa = &population->individuals[a];
+    const Individual_t *pb = &population->individuals[b];
+
+    // Скрещивание: среднее родителей, взвешенное по приспособленности
+    double wa = pa->fitness + 1e-9, wb = pb->fitness + 1e-9;
+    Individual_t child = {0};
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+      child.weights.weights[f] =
+          pa->weights.weights[f] * wa + pb->weights.weights[f] * wb;
+    }
+    normalize(&child.weights);
+    if (randomUnit(&population->rng) < MUTATION_RATE) {
+      int f = (int)(nextRandom(&population->rng) % FEATURE_COUNT);
+      child.weights.weights[f] +=
+          (randomUnit(&population->rng) * 2.0 - 1.0) * MUTATION_STEP;
+      normalize(&child.weights);
+    }
+    children[c] = child;
+  }
+  for (int c = 0; c < offspring; c++) {
+    population->individuals[population->size - 1 - c] = children[c];
+  }
+}
+
+static void initPopulation(Population_t *population, int size, uint32_t seed) {
+  population->size = size;
+  population->generation = 0;
+  population->rng = seed ? seed : 1;
+  for (int i = 0; i < size; i++) {
+    Individual_t *ind = &population->individuals[i];
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+      ind->weights.weights[f] = randomUnit(&population->rng) * 2.0 - 1.0;
+    }
+    normalize(&ind->weights);
+    ind->fitness = 0.0;
+    ind->evaluated = false;
+  }
+}
+
+// Записывает контрольную точку атомарно: во временный файл и rename
+static bool saveCheckpoint(const char *path, const Population_t *population) {
+  char tmp[4096];
+  snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+  FILE *file = fopen(tmp, "w");
+  if (!file) return false;
+
+  fprintf(file, "%s %d\n", CHECKPOINT_MAGIC, CHECKPOINT_VERSION);
+  fprintf(file, "generation %d\nrng %u\npopulation %d\nfeatures %d\n",
+          population->generation, population->rng, population->size,
+          FEATURE_COUNT);
+  for (int i = 0; i < population->size; i++) {
+    const Individual_t *ind = &population->individuals[i];
+    fprintf(file, "%d %.17g", ind->evaluated ? 1 : 0, ind->fitness);
+    for (int f = 0; f < FEATURE_COUNT; f++) {
+      fprintf(file, " %.17g", ind->weights.weights[f]);
+    }
+    fprintf(file, "\n");
+  }
+
+  bool ok = fflush(file) == 0 && fsync(fileno(file)) == 0;
+  ok = fclose(file) == 0 && ok;
+  return ok && rename(tmp, path) == 0;
+}
+
+static bool loadCheckpoint(const char *path, Population_t *population) {
+  FILE *file = fopen(path, "r");
+  if (!file) return false;
+
+  char magic[32];
+  int version, features;
+  bool ok = fscanf(file, "%31s %d", magic, &version) == 2 &&
+            strcmp(magic, CHECKPOINT_MAGIC) == 0 &&
+            version == CHECKPOINT_VERSION &&
+            fscanf(file, " generation %d rng %u population %d features %d",
+                   &population->generation, &population->rng,
+                   &population->size, &features) == 4 &&
+            features == FEATURE_COUNT && population->size > 1 &&
+            population->size <= MAX_POPULATION;
+  for (int i = 0; ok && i < population->size; i++) {
+    Individual_t *ind = &population->individuals[i];
+    int evaluated;
+    ok = fscanf(file, "%d %lf", &evaluated, &ind->fitness) == 2;
+    ind->evaluated = evaluated != 0;
+    for (int f = 0; ok && f < FEATURE_COUNT; f++) {
+      ok = fscanf(file, "%lf", &ind->weights.weights[f]) == 1;
+    }
+  }
+  fclose(file);
+  return ok;
+}
+
+static void printIndividual(const char *label, const Individual_t *ind) {
+  printf("%s %.2f [", label, ind->fitness);
+  for (int f = 0; f < FEATURE_COUNT; f++) {
+    printf("%s%.6f", f ? ", " : "", ind->weights.weights[f]);
+  }
+  printf("]\n");
+}
+
+static void printUsage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [--threads N] [--generations N] [--population N]\n"
+          "          [--games N] [--pieces N] [--seed N] [--checkpoint FILE]\n",
+          name);
+}
+
+static bool parseArgs(int argc, char **argv, TuneConfig_t *config) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (i + 1 >= argc) return false;
+    const char *value = argv[++i];
+    if (strcmp(arg, "--threads") == 0) {
+      config->threads = atoi(value);
+    } else if (strcmp(arg, "--generations") == 0) {
+      config->generations = atoi(value);
+    } else if (strcmp(arg, "--population") == 0) {
+      config->population = atoi(value);
+    } else if (strcmp(arg, "--games") == 0) {
+      config->games = atoi(value);
+    } else if (strcmp(arg, "--pieces") == 0) {
+      config->pieces = atoi(value);
+    } else if (strcmp(arg, "--seed") == 0) {
+      config->seed = (uint32_t)strtoul(value, NULL, 10);
+    } else if (strcmp(arg, "--checkpoint") == 0) {
+      config->checkpoint = value;
+    } else {
+      return false;
+    }
+  }
+  return config->threads >= 1 && config->threads <= MAX_THREADS &&
+         config->generations >= 0 && config->population >= 2 &&
+         config->population <= MAX_POPULATION && config->games >= 1 &&
+         config->pieces >= 1;
+}
+
+int main(int argc, char **argv) {
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  TuneConfig_t config = {
+      .threads = cores > 0 ? (int)(cores < MAX_THREADS ? cores : MAX_THREADS)
+                           : 1,
+      .generations = 10,
+      .population = 32,
+      .games = 8,
+      .pieces = 1000,
+      .seed = 1,
+      .checkpoint = "tune_checkpoint.txt",
+  };
+  if (!parseArgs(argc, argv, &config)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  setLeaderboardFile(NULL);
+
+  static Population_t population;
+  if (loadCheckpoint(config.checkpoint, &population)) {
+    printf("Resumed from %s at generation %d\n", config.checkpoint,
+           population.generation);
+  } else {
+    initPopulation(&population, config.population, config.seed);
+  }
+
+  for (int g = 0; g < config.generations; g++) {
+    if (!evaluatePopulation(&config, &population)) {
+      fprintf(stderr, "Out of memory\n");
+      return 1;
+    }
+    qsort(population.individuals, (size_t)population.size,
+          sizeof(Individual_t), compareFitness);
+
+    double total = 0.0;
+    for (int i = 0; i < population.size; i++) {
+      total += population.individuals[i].fitness;
+    }
+    printf("generation %d: mean %.2f lines, ", population.generation,
+           total / population.size);
+    printIndividual("best", &population.individuals[0]);
+    fflush(stdout);
+
+    breed(&population);
+    population.generation++;
+    if (!saveCheckpoint(config.checkpoint, &population)) {
+      fprintf(stderr, "Cannot write checkpoint %s\n", config.checkpoint);
+      return 1;
+    }
+  }
+  return 0;
+}